@@ -4,7 +4,6 @@
 #include "app_state/game.h"
 #include "app_state/menu.h"
 
-#include <ctime>
 #include <iostream>
 #include <stdlib.h>
 #include <SDL2/SDL.h>
@@ -16,6 +15,9 @@
 App::App()
 {
     m_window = nullptr;
+    m_app_state = nullptr;
+    m_game_config = GameConfig::defaults();
+    m_time_scale = 1;
 }
 
 App::~App()
@@ -44,51 +46,72 @@ void App::run()
         AppConfig::sounds[SND_fire] = Mix_LoadWAV("sounds/fire.wav");
         AppConfig::sounds[SND_hit] = Mix_LoadWAV("sounds/hit.wav");
 
-        srand(time(NULL)); // initializing the pseudo-random number generator
+        m_engine.initModules();
+        if(!AppConfig::sprites_path.empty() && !m_engine.getSpriteConfig()->load(AppConfig::sprites_path))
+            std::cerr << "Cannot load sprite sheet description " << AppConfig::sprites_path << std::endl;
+        m_engine.getRenderer()->loadTexture(m_window);
+        m_engine.getRenderer()->loadFont();
 
-        Engine& engine = Engine::getEngine();
-        engine.initModules();
-        engine.getRenderer()->loadTexture(m_window);
-        engine.getRenderer()->loadFont();
-
-        m_app_state = new Menu;
+        Replay replay;
+        if(!m_replay_path.empty() && replay.load(m_replay_path)) m_app_state = new Game(&m_engine, replay, m_game_config);
+        else
+        {
+            if(!m_replay_path.empty()) std::cerr << "Cannot load replay " << m_replay_path << std::endl;
+            m_app_state = new Menu(&m_engine, m_game_config);
+        }
 
-        double FPS;
-        Uint32 time1, time2, dt, fps_time = 0, fps_count = 0, delay = 15;
+        // fixed time step: the simulation always advances by AppConfig::sim_tick_time,
+        // drawing happens once per frame independently of the number of simulated steps
+        Uint32 time1, time2, lag = 0;
         time1 = SDL_GetTicks();
         while(is_running)
         {
             time2 = SDL_GetTicks();
-            dt = time2 - time1;
+            lag += time2 - time1;
             time1 = time2;
 
             if(m_app_state->finished())
             {
+                saveRecording();
                 AppState* new_state = m_app_state->nextState();
                 delete m_app_state;
                 m_app_state = new_state;
+                startRecording();
             }
             if(m_app_state == nullptr) break;
 
             eventProces();
 
-            m_app_state->update(dt);
-            m_app_state->draw();
-
-            SDL_Delay(delay);
-
-            //FPS
-            fps_time += dt; fps_count++;
-            if(fps_time > 200)
+            // fast forward: a step of a game makes m_time_scale steps, the start screen and the end of a level are then
+            // simulated as fast as possible; the simulation stops when the time of a frame is spent, so frames are still drawn
+            Game* game = dynamic_cast<Game*>(m_app_state);
+            unsigned ticks = 0;
+            bool behind = false;
+            while(!m_app_state->finished())
             {
-                FPS = (double)fps_count / fps_time * 1000;
-                if(FPS > 60) delay++;
-                else if(delay > 0) delay--;
-                fps_time = 0; fps_count = 0;
+                unsigned scale = (game == nullptr || m_time_scale == 1 ? 1 : game->isWaiting() ? 0 : m_time_scale);
+                if(scale == 0) lag = 0;
+                else if(lag < AppConfig::sim_tick_time) break;
+                if(scale == 1 ? ticks == AppConfig::sim_max_ticks_per_frame : SDL_GetTicks() - time2 >= AppConfig::sim_frame_budget)
+                {
+                    behind = true;
+                    break;
+                }
+
+                if(game != nullptr) game->setTimeScale(m_time_scale);
+                m_app_state->update(AppConfig::sim_tick_time);
+                if(scale != 0) lag -= AppConfig::sim_tick_time;
+                ticks++;
             }
+            if(behind) lag %= AppConfig::sim_tick_time; // too far behind, slow down the game instead of catching up
+
+            m_app_state->draw();
+
+            if(ticks == 0) SDL_Delay(1); // do not spin if vsync is not available
         }
 
-        engine.destroyModules();
+        if(m_app_state != nullptr) saveRecording();
+        m_engine.destroyModules();
     }
 
     SDL_DestroyWindow(m_window);
@@ -99,6 +122,44 @@ void App::run()
     SDL_Quit();
 }
 
+void App::setRecordPath(const std::string& path)
+{
+    m_record_path = path;
+}
+
+void App::setReplayPath(const std::string& path)
+{
+    m_replay_path = path;
+}
+
+void App::setGameConfig(GameConfigPtr config)
+{
+    m_game_config = config;
+}
+
+void App::setTimeScale(unsigned scale)
+{
+    m_time_scale = scale;
+}
+
+void App::startRecording()
+{
+    Game* game = dynamic_cast<Game*>(m_app_state);
+    if(game != nullptr && !m_record_path.empty() && !game->isReplaying())
+        game->startRecording(AppConfig::sim_tick_time);
+}
+
+void App::saveRecording()
+{
+    Game* game = dynamic_cast<Game*>(m_app_state);
+    if(game != nullptr && !m_record_path.empty() && !game->isReplaying())
+    {
+        const Replay& replay = game->getReplay();
+        std::string path = m_record_path + "." + Engine::intToString(replay.getLevel());
+        if(!replay.save(path)) std::cerr << "Cannot save replay " << path << std::endl;
+    }
+}
+
 void App::eventProces()
 {
     SDL_Event event;
@@ -118,10 +179,21 @@ void App::eventProces()
 
                 AppConfig::windows_rect.w = event.window.data1;
                 AppConfig::windows_rect.h = event.window.data2;
-                Engine::getEngine().getRenderer()->setScale((float)AppConfig::windows_rect.w / (AppConfig::map_rect.w + AppConfig::status_rect.w),
-                                                            (float)AppConfig::windows_rect.h / AppConfig::map_rect.h);
+                m_engine.getRenderer()->setScale((float)AppConfig::windows_rect.w / (AppConfig::map_rect.w + AppConfig::status_rect.w),
+                                             (float)AppConfig::windows_rect.h / AppConfig::map_rect.h);
             }
         }
+        else if(event.type == SDL_RENDER_TARGETS_RESET)
+        {
+            // the content of the map layer was lost, it is created and drawn again in the next frame
+            m_engine.getRenderer()->resetLayer();
+        }
+
+        else if(event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_f && dynamic_cast<Game*>(m_app_state) != nullptr)
+        {
+            // 1x, 10x, 100x, as fast as possible and back to 1x
+            m_time_scale = (m_time_scale == 0 ? 1 : m_time_scale >= 100 ? 0 : m_time_scale * 10);
+        }
 
         m_app_state->eventProcess(&event);
     }
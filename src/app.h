@@ -2,6 +2,9 @@
 #define APP_H
 
 #include "app_state/appstate.h"
+#include "gameconfig.h"
+#include "engine/engine.h"
+#include <string>
 
 /**
  * @brief
@@ -20,9 +23,39 @@ public:
     void run();
     /**
      * Function handling events waiting in the queue.
+     * F changes the speed of a game: 1x, 10x, 100x, as fast as possible and back to 1x.
      */
     void eventProces();
+    /**
+     * Enabling the recording of every played level. Level N is written to the file <em>path.N</em>.
+     * @param path - beginning of the names of replay files
+     */
+    void setRecordPath(const std::string& path);
+    /**
+     * Starting the application with the playback of a recorded level instead of the menu.
+     * @param path - replay file written with @a setRecordPath
+     */
+    void setReplayPath(const std::string& path);
+    /**
+     * Setting the rules of all games played in the application.
+     * @param config - configuration, @a GameConfig::defaults if it is not set
+     */
+    void setGameConfig(GameConfigPtr config);
+    /**
+     * Setting the speed of the games compared to real time.
+     * @param scale - 1, 10 or 100 steps per step of real time, or 0 to simulate as fast as possible
+     */
+    void setTimeScale(unsigned scale);
 private:
+    /**
+     * Starting the recording of the current state if it is a game and recording is enabled.
+     */
+    void startRecording();
+    /**
+     * Writing the replay of the current state if it is a recorded game. It has to be called before @a AppState::nextState takes the players away.
+     */
+    void saveRecording();
+
     /**
      * Variable maintaining the operation of the main program loop.
      */
@@ -35,6 +68,26 @@ private:
      * Application window object.
      */
     SDL_Window* m_window;
+    /**
+     * Beginning of the names of replay files, empty if levels are not recorded.
+     */
+    std::string m_record_path;
+    /**
+     * Replay file played at the start of the application, empty to show the menu.
+     */
+    std::string m_replay_path;
+    /**
+     * Context of the session played in the window, with the renderer.
+     */
+    Engine m_engine;
+    /**
+     * Rules of the games played in the application.
+     */
+    GameConfigPtr m_game_config;
+    /**
+     * Speed of the games, see @a setTimeScale.
+     */
+    unsigned m_time_scale;
 };
 
 #endif // APP_H
@@ -24,7 +24,7 @@ public:
     virtual void draw() = 0;
     /**
      * Function updating the state of objects and counters in the game
-     * @param dt - time since the last function call in milliseconds
+     * @param dt - length of the simulation step in milliseconds, equal to @a AppConfig::sim_tick_time in the application main loop
      */
     virtual void update(Uint32 dt) = 0;
     /**
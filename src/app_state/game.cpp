@@ -9,62 +9,109 @@
 #include <ctime>
 #include <fstream>
 #include <algorithm>
+#include <climits>
 #include <iostream>
 #include <cmath>
+#include <cstring>
 
-Game::Game()
+Game::Game(Engine* engine)
+    : m_bullet_pool(engine), m_level(engine)
 {
-    m_level_columns_count = 0;
-    m_level_rows_count = 0;
+    m_engine = engine;
+    m_config = GameConfig::defaults();
+    m_show_enemy_target = m_config->show_enemy_target;
+    m_show_draw_stats = m_config->show_draw_stats;
+    m_seed = 0;
+    m_recording = false;
+    m_replaying = false;
     m_current_level = 0;
     m_eagle = nullptr;
     m_player_count = 1;
     m_enemy_redy_time = 0;
     m_pause = false;
+    m_time_scale = 1;
     m_level_end_time = 0;
     m_protect_eagle = false;
     m_protect_eagle_time = 0;
     m_enemy_respown_position = 0;
+    m_flow_revision = 0;
     nextLevel();
 }
 
-Game::Game(int players_count)
+Game::Game(Engine* engine, int players_count, Uint64 seed, int start_level, GameConfigPtr config)
+    : m_random(seed), m_bullet_pool(engine), m_level(engine)
 {
-    m_level_columns_count = 0;
-    m_level_rows_count = 0;
-    m_current_level = 0;
+    m_engine = engine;
+    m_config = config;
+    m_show_enemy_target = m_config->show_enemy_target;
+    m_show_draw_stats = m_config->show_draw_stats;
+    m_seed = seed;
+    m_recording = false;
+    m_replaying = false;
+    m_current_level = start_level - 1;
     m_eagle = nullptr;
     m_player_count = players_count;
+    m_enemy_redy_time = 0;
     m_pause = false;
+    m_time_scale = 1;
     m_level_end_time = 0;
     m_protect_eagle = false;
     m_protect_eagle_time = 0;
     m_enemy_respown_position = 0;
+    m_flow_revision = 0;
     nextLevel();
 }
 
-Game::Game(std::vector<Player *> players, int previous_level)
+Game::Game(Engine* engine, std::vector<Player *> players, int previous_level, Uint64 seed, GameConfigPtr config)
+    : m_random(seed), m_bullet_pool(engine), m_level(engine)
 {
-    m_level_columns_count = 0;
-    m_level_rows_count = 0;
+    m_engine = engine;
+    m_config = config;
+    m_show_enemy_target = m_config->show_enemy_target;
+    m_show_draw_stats = m_config->show_draw_stats;
+    m_seed = seed;
+    m_recording = false;
+    m_replaying = false;
     m_current_level = previous_level;
     m_eagle = nullptr;
     m_players = players;
+    // keep the order of a new game, the order of updates has to be the same when the level is replayed
+    std::sort(m_players.begin(), m_players.end(), [](Player* a, Player* b){return a->type < b->type;});
     m_player_count = m_players.size();
     for(auto player : m_players)
     {
+        // bullets still flying at the end of the previous level are removed
+        player->setBulletPool(&m_bullet_pool);
+        player->setConfig(m_config.get());
         player->clearFlag(TSF_MENU);
         player->lives_count++;
         player->respawn();
+        player->resetAnimation();
     }
+    m_enemy_redy_time = 0;
     m_pause = false;
+    m_time_scale = 1;
     m_level_end_time = 0;
     m_protect_eagle = false;
     m_protect_eagle_time = 0;
     m_enemy_respown_position = 0;
+    m_flow_revision = 0;
     nextLevel();
 }
 
+Game::Game(Engine* engine, const Replay &replay, GameConfigPtr config)
+    : Game(engine, replay.getPlayersCount(), replay.getSeed(), replay.getLevel(), config)
+{
+    m_replay = replay;
+    m_replay.rewind();
+    m_replaying = true;
+    for(auto player : m_players)
+    {
+        player->setProgress(m_replay.getProgress(player->type == ST_PLAYER_1 ? 0 : 1));
+        player->external_input = true;
+    }
+}
+
 Game::~Game()
 {
     clearLevel();
@@ -72,8 +119,8 @@ Game::~Game()
 
 void Game::draw()
 {
-    Engine& engine = Engine::getEngine();
-    Renderer* renderer = engine.getRenderer();
+    Renderer* renderer = m_engine->getRenderer();
+    if(renderer == nullptr) return;
     renderer->clear();
 
     if(m_level_start_screen)
@@ -84,12 +131,14 @@ void Game::draw()
     else
     {
         renderer->drawRect(&AppConfig::map_rect, {0, 0, 0, 0}, true);
-        for(auto row : m_level)
-            for(auto item : row)
-                if(item != nullptr) item->draw();
+        m_level.draw();
 
         for(auto player : m_players) player->draw();
-        for(auto enemy : m_enemies) enemy->draw();
+        for(auto enemy : m_enemies)
+        {
+            if(m_show_enemy_target) enemy->drawTarget();
+            enemy->draw();
+        }
         for(auto bush : m_bushes) bush->draw();
         for(auto bonus : m_bonuses) bonus->draw();
         m_eagle->draw();
@@ -103,7 +152,7 @@ void Game::draw()
         }
 
         //===========Status gry===========
-        SDL_Rect src = engine.getSpriteConfig()->getSpriteData(ST_LEFT_ENEMY)->rect;
+        SDL_Rect src = m_engine->getSpriteConfig()->getSpriteData(ST_LEFT_ENEMY)->rect;
         SDL_Rect dst;
         SDL_Point p_dst;
         //wrogowie do zabicia
@@ -123,11 +172,26 @@ void Game::draw()
             renderer->drawText(&p_dst, Engine::intToString(player->lives_count), {0, 0, 0, 255}, 3);
         }
         //numer mapy
-        src = engine.getSpriteConfig()->getSpriteData(ST_STAGE_STATUS)->rect;
+        src = m_engine->getSpriteConfig()->getSpriteData(ST_STAGE_STATUS)->rect;
         dst = {AppConfig::status_rect.x + 8, static_cast<int>(185 + (m_players.size() + m_killed_players.size()) * 18), src.w, src.h};
         p_dst = {dst.x + 10, dst.y + 26};
         renderer->drawObject(&src, &dst);
         renderer->drawText(&p_dst, Engine::intToString(m_current_level), {0, 0, 0, 255}, 2);
+        //statystyki rysowania poprzedniej klatki
+        if(m_show_draw_stats)
+        {
+            p_dst = {AppConfig::status_rect.x + 4, AppConfig::status_rect.h - 30};
+            renderer->drawText(&p_dst, "DC " + Engine::intToString(renderer->getDrawCallsCount()), {0, 0, 0, 255}, 3);
+            p_dst.y += 12;
+            renderer->drawText(&p_dst, "SP " + Engine::intToString(renderer->getSpritesCount()), {0, 0, 0, 255}, 3);
+        }
+
+        //szybkość symulacji
+        if(m_time_scale != 1)
+        {
+            p_dst = {AppConfig::status_rect.x + 4, AppConfig::status_rect.h - 42};
+            renderer->drawText(&p_dst, m_time_scale == 0 ? std::string("MAX") : "x" + Engine::intToString(m_time_scale), {0, 0, 0, 255}, 3);
+        }
 
         if(m_pause)
             renderer->drawText(nullptr, std::string("PAUSE"), {200, 0, 0, 255}, 1);
@@ -138,32 +202,69 @@ void Game::draw()
 
 void Game::update(Uint32 dt)
 {
-    if(dt > 40) return;
+    // a step longer than the limit is split into equal shorter steps, the rest of the division is spread over the first of them
+    const Uint32 max_step = maxStepTime();
+    unsigned parts = (dt + max_step - 1) / max_step;
+    if(parts == 0) parts = 1;
+    unsigned steps = (m_time_scale == 0 ? 1 : m_time_scale);
+    for(unsigned i = 0; i < steps && !m_finished; i++)
+        for(unsigned p = 0; p < parts && !m_finished; p++)
+            step(dt / parts + (p < dt % parts ? 1 : 0));
+}
+
+Uint32 Game::maxStepTime() const
+{
+    // bullets of tanks with stars are the fastest objects, they fly 1.3 times faster than the others
+    const SDL_Rect& bullet = m_engine->getSpriteConfig()->getSpriteData(ST_BULLET)->rect;
+    double fastest = m_config->bullet_default_speed * 1.3;
+    Uint32 time = (fastest > 0 ? std::min(bullet.w, bullet.h) / fastest : AppConfig::sim_max_tick_time);
+    if(time < 1) time = 1;
+    return std::min<Uint32>(time, AppConfig::sim_max_tick_time);
+}
+
+void Game::step(Uint32 dt)
+{
+    if(m_pause && !m_level_start_screen) return;
+
+    if(m_replaying)
+    {
+        PlayerInputs input1, input2;
+        if(!m_replay.next(input1, input2))
+        {
+            m_finished = true;
+            return;
+        }
+        setPlayerInput(0, input1);
+        setPlayerInput(1, input2);
+    }
 
     if(m_level_start_screen)
     {
-        if(m_level_start_time > AppConfig::level_start_time)
+        if(m_level_start_time > m_config->level_start_time)
             m_level_start_screen = false;
 
         m_level_start_time += dt;
     }
     else
     {
-        if(m_pause) return;
-
-        std::vector<Player*>::iterator pl1, pl2;
-        std::vector<Enemy*>::iterator en1, en2;
+        // Broad phase: only objects sharing a grid cell are checked below, in the same order as if all pairs were checked
+        buildBroadphase(dt);
 
         // Check collision of player tanks with each other
-        for(pl1 = m_players.begin(); pl1 != m_players.end(); pl1++)
-            for(pl2 = pl1 + 1; pl2 != m_players.end(); pl2++)
-                checkCollisionTwoTanks(*pl1, *pl2, dt);
-
+        for(unsigned i = 0; i < m_players.size(); i++)
+        {
+            m_player_grid.query(tankBounds(m_players[i], dt), m_candidates);
+            for(int j : m_candidates)
+                if(j > (int)i) checkCollisionTwoTanks(m_players[i], m_players[j], dt);
+        }
 
         // Check collision of enemy tanks with each other
-        for(en1 = m_enemies.begin(); en1 != m_enemies.end(); en1++)
-             for(en2 = en1 + 1; en2 != m_enemies.end(); en2++)
-                checkCollisionTwoTanks(*en1, *en2, dt);
+        for(unsigned i = 0; i < m_enemies.size(); i++)
+        {
+            m_enemy_grid.query(tankBounds(m_enemies[i], dt), m_candidates);
+            for(int j : m_candidates)
+                if(j > (int)i) checkCollisionTwoTanks(m_enemies[i], m_enemies[j], dt);
+        }
 
         // Check collision of bullet with level
         for(auto enemy : m_enemies)
@@ -178,8 +279,25 @@ void Game::update(Uint32 dt)
 
 
         for(auto player : m_players)
-            for(auto enemy : m_enemies)
+        {
+            m_player_bullet_rects.clear();
+            for(auto bullet : player->bullets) m_player_bullet_rects.add(bullet->collision_rect);
+
+            // enemies close to the player, to the player's bullets or having bullets close to the player's bullets
+            m_enemy_grid.query(tankBounds(player, dt), m_candidates);
+            for(auto bullet : player->bullets)
             {
+                m_enemy_grid.query(bullet->collision_rect, m_query);
+                m_candidates.insert(m_candidates.end(), m_query.begin(), m_query.end());
+                m_enemy_bullet_grid.query(bullet->collision_rect, m_query);
+                for(int b : m_query) m_candidates.push_back(m_enemy_bullet_owners[b]);
+            }
+            std::sort(m_candidates.begin(), m_candidates.end());
+            m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()), m_candidates.end());
+
+            for(int e : m_candidates)
+            {
+                Enemy* enemy = m_enemies[e];
                 // Check collision of enemy tanks with players
                 checkCollisionTwoTanks(player, enemy, dt);
                 // Check collision of player's bullets with enemy
@@ -190,11 +308,19 @@ void Game::update(Uint32 dt)
                      for(auto bullet2 : enemy->bullets)
                             checkCollisionTwoBullets(bullet1, bullet2);
             }
+        }
 
-        // Check collision of enemy bullet with player
+        // Check collision of enemy bullet with player: every player is tested against all bullets of enemies at once
+        m_player_hits.resize(m_players.size());
+        for(unsigned p = 0; p < m_players.size(); p++)
+            m_enemy_bullet_rects.intersect(m_players[p]->collision_rect, m_player_hits[p]);
+        unsigned first_bullet = 0;
         for(auto enemy : m_enemies)
-            for(auto player : m_players)
-                    checkCollisionEnemyBulletsWithPlayer(enemy, player);
+        {
+            for(unsigned p = 0; p < m_players.size(); p++)
+                checkCollisionEnemyBulletsWithPlayer(enemy, m_players[p], m_player_hits[p], first_bullet);
+            first_bullet += enemy->bullets.size();
+        }
 
         // Checking collision of player with bonus
         for(auto player : m_players)
@@ -206,31 +332,8 @@ void Game::update(Uint32 dt)
         for(auto player : m_players) checkCollisionTankWithLevel(player, dt);
 
         // Assigning targets to enemies
-        int min_metric; // 2 * 26 * 16
-        int metric;
-        SDL_Point target;
-        for(auto enemy : m_enemies)
-        {
-            min_metric = 832;
-            if(enemy->type == ST_TANK_A || enemy->type == ST_TANK_D)
-                for(auto player : m_players)
-                {
-                    metric = fabs(player->dest_rect.x - enemy->dest_rect.x) + fabs(player->dest_rect.y - enemy->dest_rect.y);
-                    if(metric < min_metric)
-                    {
-                        min_metric = metric;
-                        target = {player->dest_rect.x + player->dest_rect.w / 2, player->dest_rect.y + player->dest_rect.h / 2};
-                    }
-                }
-            metric = fabs(m_eagle->dest_rect.x - enemy->dest_rect.x) + fabs(m_eagle->dest_rect.y - enemy->dest_rect.y);
-            if(metric < min_metric)
-            {
-                min_metric = metric;
-                target = {m_eagle->dest_rect.x + m_eagle->dest_rect.w / 2, m_eagle->dest_rect.y + m_eagle->dest_rect.h / 2};
-            }
-
-            enemy->target_position = target;
-        }
+        updateFlowFields();
+        assignEnemyTargets();
 
         // Update all objects
         for(auto enemy : m_enemies) enemy->update(dt);
@@ -238,10 +341,7 @@ void Game::update(Uint32 dt)
         for(auto bonus : m_bonuses) bonus->update(dt);
         m_eagle->update(dt);
 
-        for(auto row : m_level)
-            for(auto item : row)
-                if(item != nullptr) item->update(dt);
-
+        m_level.update(dt);
 
         for(auto bush : m_bushes) bush->update(dt);
 
@@ -253,7 +353,7 @@ void Game::update(Uint32 dt)
 
         // Add a new enemy
         m_enemy_redy_time += dt;
-        if(m_enemies.size() < (AppConfig::enemy_max_count_on_map < m_enemy_to_kill ? AppConfig::enemy_max_count_on_map : m_enemy_to_kill) && m_enemy_redy_time > AppConfig::enemy_redy_time)
+        if(m_enemies.size() < (m_config->enemy_max_count_on_map < m_enemy_to_kill ? m_config->enemy_max_count_on_map : m_enemy_to_kill) && m_enemy_redy_time > m_config->enemy_redy_time)
         {
             m_enemy_redy_time = 0;
             generateEnemy();
@@ -262,7 +362,7 @@ void Game::update(Uint32 dt)
         if(m_enemies.empty() && m_enemy_to_kill <= 0)
         {
             m_level_end_time += dt;
-            if(m_level_end_time > AppConfig::level_end_time)
+            if(m_level_end_time > m_config->level_end_time)
                 m_finished = true;
         }
 
@@ -276,74 +376,34 @@ void Game::update(Uint32 dt)
         if(m_game_over)
         {
             if(m_game_over_position < 10) m_finished = true;
-            else m_game_over_position -= AppConfig::game_over_entry_speed * dt;
+            else m_game_over_position -= m_config->game_over_entry_speed * dt;
         }
 
         if(m_protect_eagle)
         {
             m_protect_eagle_time += dt;
-            if(m_protect_eagle_time > AppConfig::protect_eagle_time)
+            if(m_protect_eagle_time > m_config->protect_eagle_time)
             {
                 m_protect_eagle = false;
                 m_protect_eagle_time = 0;
-                for(int i = 0; i < 3; i++)
-                {
-                    if(m_level.at(m_level_rows_count - i - 1).at(11) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(11);
-                    m_level.at(m_level_rows_count - i - 1).at(11) = new Brick(11 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1) * AppConfig::tile_rect.h);
-
-                    if(m_level.at(m_level_rows_count - i - 1).at(14) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(14);
-                    m_level.at(m_level_rows_count - i - 1).at(14) = new Brick(14 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1)  * AppConfig::tile_rect.h);
-                }
-                for(int i = 12; i < 14; i++)
-                {
-                    if(m_level.at(m_level_rows_count - 3).at(i) != nullptr)
-                        delete m_level.at(m_level_rows_count - 3).at(i);
-                    m_level.at(m_level_rows_count - 3).at(i) = new Brick(i * AppConfig::tile_rect.w, (m_level_rows_count - 3) * AppConfig::tile_rect.h);
-                }
+                setEagleWalls(ST_BRICK_WALL);
             }
 
-            if(m_protect_eagle && m_protect_eagle_time > AppConfig::protect_eagle_time / 4 * 3 && m_protect_eagle_time / AppConfig::bonus_blink_time % 2)
-            {
-                for(int i = 0; i < 3; i++)
-                {
-                    if(m_level.at(m_level_rows_count - i - 1).at(11) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(11);
-                    m_level.at(m_level_rows_count - i - 1).at(11) = new Brick(11 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1) * AppConfig::tile_rect.h);
-
-                    if(m_level.at(m_level_rows_count - i - 1).at(14) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(14);
-                    m_level.at(m_level_rows_count - i - 1).at(14) = new Brick(14 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1)  * AppConfig::tile_rect.h);
-                }
-                for(int i = 12; i < 14; i++)
-                {
-                    if(m_level.at(m_level_rows_count - 3).at(i) != nullptr)
-                        delete m_level.at(m_level_rows_count - 3).at(i);
-                    m_level.at(m_level_rows_count - 3).at(i) = new Brick(i * AppConfig::tile_rect.w, (m_level_rows_count - 3) * AppConfig::tile_rect.h);
-                }
-            }
+            // the stone walls blink before the protection ends
+            if(m_protect_eagle && m_protect_eagle_time > m_config->protect_eagle_time / 4 * 3 && m_protect_eagle_time / m_config->bonus_blink_time % 2)
+                setEagleWalls(ST_BRICK_WALL);
             else if(m_protect_eagle)
-            {
-                for(int i = 0; i < 3; i++)
-                {
-                    if(m_level.at(m_level_rows_count - i - 1).at(11) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(11);
-                    m_level.at(m_level_rows_count - i - 1).at(11) = new Object(11 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1) * AppConfig::tile_rect.h, ST_STONE_WALL);
-
-                    if(m_level.at(m_level_rows_count - i - 1).at(14) != nullptr)
-                        delete m_level.at(m_level_rows_count - i - 1).at(14);
-                    m_level.at(m_level_rows_count - i - 1).at(14) = new Object(14 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1)  * AppConfig::tile_rect.h, ST_STONE_WALL);
-                }
-                for(int i = 12; i < 14; i++)
-                {
-                    if(m_level.at(m_level_rows_count - 3).at(i) != nullptr)
-                        delete m_level.at(m_level_rows_count - 3).at(i);
-                    m_level.at(m_level_rows_count - 3).at(i) = new Object(i * AppConfig::tile_rect.w, (m_level_rows_count - 3) * AppConfig::tile_rect.h, ST_STONE_WALL);
-                }
-            }
+                setEagleWalls(ST_STONE_WALL);
         }
     }
+
+    if(m_recording)
+    {
+        PlayerInputs inputs[2] = {0, 0};
+        for(auto player : m_players)
+            inputs[player->type == ST_PLAYER_1 ? 0 : 1] = player->input;
+        m_replay.record(inputs[0], inputs[1]);
+    }
 }
 
 void Game::eventProcess(SDL_Event *ev)
@@ -362,7 +422,10 @@ void Game::eventProcess(SDL_Event *ev)
             m_finished = true;
             break;
         case SDLK_t:
-            AppConfig::show_enemy_target = !AppConfig::show_enemy_target;
+            m_show_enemy_target = !m_show_enemy_target;
+            break;
+        case SDLK_i:
+            m_show_draw_stats = !m_show_draw_stats;
             break;
         case SDLK_RETURN:
             m_pause = !m_pause;
@@ -387,53 +450,42 @@ void Game::loadLevel(std::string path)
 {
     std::fstream level(path, std::ios::in);
     std::string line;
-    int j = -1;
+    std::vector<std::string> lines;
 
     if(level.is_open())
     {
         while(!level.eof())
         {
             std::getline(level, line);
-            std::vector<Object*> row;
-            j++;
-            for(unsigned i = 0; i < line.size(); i++)
-            {
-                Object* obj;
-                switch(line.at(i))
-                {
-                case '#' : obj = new Brick(i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h); break;
-                case '@' : obj = new Object(i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h, ST_STONE_WALL); break;
-                case '%' : m_bushes.push_back(new Object(i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h, ST_BUSH)); obj =  nullptr; break;
-                case '~' : obj = new Object(i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h, ST_WATER); break;
-                case '-' : obj = new Object(i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h, ST_ICE); break;
-                default: obj = nullptr;
-                }
-                row.push_back(obj);
-            }
-            m_level.push_back(row);
+            lines.push_back(line);
         }
     }
 
-    m_level_rows_count = m_level.size();
-    if(m_level_rows_count)
-        m_level_columns_count = m_level.at(0).size();
-    else m_level_columns_count = 0;
-
-    // create the eagle
-    m_eagle = new Eagle(12 * AppConfig::tile_rect.w, (m_level_rows_count - 2) * AppConfig::tile_rect.h);
-
-    // clear the eagle's space
-    for(int i = 12; i < 14 && i < m_level_columns_count; i++)
+    int rows_count = lines.size();
+    int columns_count = rows_count ? lines.at(0).size() : 0;
+    m_level.resize(rows_count, columns_count);
+    for(int j = 0; j < rows_count; j++)
     {
-        for(int j = m_level_rows_count - 2; j < m_level_rows_count; j++)
+        for(int i = 0; i < columns_count && i < (int)lines.at(j).size(); i++)
         {
-            if(m_level.at(j).at(i) != nullptr)
+            switch(lines.at(j).at(i))
             {
-                delete m_level.at(j).at(i);
-                m_level.at(j).at(i) = nullptr;
+            case '#' : m_level.set(j, i, ST_BRICK_WALL); break;
+            case '@' : m_level.set(j, i, ST_STONE_WALL); break;
+            case '%' : m_bushes.push_back(new Object(m_engine, i * AppConfig::tile_rect.w, j * AppConfig::tile_rect.h, ST_BUSH)); break;
+            case '~' : m_level.set(j, i, ST_WATER); break;
+            case '-' : m_level.set(j, i, ST_ICE); break;
             }
         }
     }
+
+    // create the eagle
+    m_eagle = new Eagle(m_engine, 12 * AppConfig::tile_rect.w, (rows_count - 2) * AppConfig::tile_rect.h);
+
+    // clear the eagle's space
+    for(int i = 12; i < 14 && i < columns_count; i++)
+        for(int j = std::max(rows_count - 2, 0); j < rows_count; j++)
+            m_level.set(j, i, ST_NONE);
 }
 
 bool Game::finished() const
@@ -446,13 +498,389 @@ AppState* Game::nextState()
     if(m_game_over || m_enemy_to_kill <= 0)
     {
         m_players.erase(std::remove_if(m_players.begin(), m_players.end(), [this](Player*p){m_killed_players.push_back(p); return true;}), m_players.end());
-        Scores* scores = new Scores(m_killed_players, m_current_level, m_game_over);
+        for(auto player : m_killed_players) player->setBulletPool(nullptr); // the pool is deleted with the game
+        Scores* scores = new Scores(m_engine, m_killed_players, m_current_level, m_game_over, m_random.next(), m_config);
+        m_killed_players.clear(); // players are owned by the scores screen now
         return scores;
     }
-    Menu* m = new Menu;
+    Menu* m = new Menu(m_engine, m_config);
     return m;
 }
 
+bool Game::isGameOver() const
+{
+    return m_game_over;
+}
+
+bool Game::isWaiting() const
+{
+    return m_level_start_screen || (!m_pause && m_enemies.empty() && m_enemy_to_kill <= 0);
+}
+
+void Game::setTimeScale(unsigned scale)
+{
+    m_time_scale = scale;
+}
+
+unsigned Game::getTimeScale() const
+{
+    return m_time_scale;
+}
+
+int Game::getCurrentLevel() const
+{
+    return m_current_level;
+}
+
+int Game::getEnemyToKill() const
+{
+    return m_enemy_to_kill;
+}
+
+unsigned Game::getScore() const
+{
+    unsigned score = 0;
+    for(auto player : m_players) score += player->score;
+    for(auto player : m_killed_players) score += player->score;
+    return score;
+}
+
+const std::vector<Player*>& Game::getPlayers() const
+{
+    return m_players;
+}
+
+const std::vector<Enemy*>& Game::getEnemies() const
+{
+    return m_enemies;
+}
+
+const Eagle* Game::getEagle() const
+{
+    return m_eagle;
+}
+
+const std::vector<Bonus*>& Game::getBonuses() const
+{
+    return m_bonuses;
+}
+
+const std::vector<Object*>& Game::getBushes() const
+{
+    return m_bushes;
+}
+
+const GameConfig& Game::getConfig() const
+{
+    return *m_config;
+}
+
+const Level& Game::getLevel() const
+{
+    return m_level;
+}
+
+bool Game::lineOfSight(const SDL_Point& from, const SDL_Point& to, int thickness) const
+{
+    if(m_level.getRowsCount() == 0 || m_level.getColumnsCount() == 0) return false;
+    int tile_w = AppConfig::tile_rect.w, tile_h = AppConfig::tile_rect.h;
+    if(from.x == to.x)
+    {
+        // the bullet covers the columns from its left to its right edge
+        int first_column = max(0, (from.x - thickness / 2) / tile_w);
+        int last_column = min(m_level.getColumnsCount() - 1, (from.x + (thickness + 1) / 2 - 1) / tile_w);
+        int first_row = max(0, min(from.y, to.y) / tile_h);
+        int last_row = min(m_level.getRowsCount() - 1, max(from.y, to.y) / tile_h);
+        for(int column = first_column; column <= last_column; column++)
+            if(!m_level.columnClear(column, first_row, last_row)) return false;
+        return true;
+    }
+    if(from.y == to.y)
+    {
+        int first_row = max(0, (from.y - thickness / 2) / tile_h);
+        int last_row = min(m_level.getRowsCount() - 1, (from.y + (thickness + 1) / 2 - 1) / tile_h);
+        int first_column = max(0, min(from.x, to.x) / tile_w);
+        int last_column = min(m_level.getColumnsCount() - 1, max(from.x, to.x) / tile_w);
+        for(int row = first_row; row <= last_row; row++)
+            if(!m_level.rowClear(row, first_column, last_column)) return false;
+        return true;
+    }
+    return false;
+}
+
+const BulletPool& Game::getBulletPool() const
+{
+    return m_bullet_pool;
+}
+
+void Game::setPlayerInput(int player_index, PlayerInputs input)
+{
+    SpriteType type = (player_index == 0 ? ST_PLAYER_1 : ST_PLAYER_2);
+    for(auto player : m_players)
+    {
+        if(player->type != type) continue;
+        player->external_input = true;
+        player->input = input;
+    }
+}
+
+void Game::startRecording(Uint32 dt)
+{
+    std::vector<Player::Progress> progress(m_players.size());
+    for(auto player : m_players)
+        progress.at(player->type == ST_PLAYER_1 ? 0 : progress.size() - 1) = player->getProgress();
+    m_replay.start(m_seed, m_current_level, dt, progress);
+    m_recording = true;
+}
+
+const Replay& Game::getReplay()
+{
+    m_replay.finish(checksum());
+    return m_replay;
+}
+
+bool Game::isReplaying() const
+{
+    return m_replaying;
+}
+
+static void hashValue(Uint64& hash, Uint64 value)
+{
+    for(int i = 0; i < 8; i++)
+    {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+}
+
+static void hashDouble(Uint64& hash, double value)
+{
+    Uint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    hashValue(hash, bits);
+}
+
+static void hashRect(Uint64& hash, const SDL_Rect& rect)
+{
+    hashValue(hash, rect.x);
+    hashValue(hash, rect.y);
+    hashValue(hash, rect.w);
+    hashValue(hash, rect.h);
+}
+
+static void hashTank(Uint64& hash, const Tank* tank)
+{
+    hashValue(hash, tank->type);
+    hashDouble(hash, tank->pos_x);
+    hashDouble(hash, tank->pos_y);
+    hashValue(hash, tank->direction);
+    hashValue(hash, tank->lives_count);
+    for(auto bullet : tank->bullets)
+    {
+        hashDouble(hash, bullet->pos_x);
+        hashDouble(hash, bullet->pos_y);
+        hashValue(hash, bullet->direction);
+    }
+}
+
+Uint64 Game::checksum() const
+{
+    Uint64 hash = 14695981039346656037ULL;
+    hashValue(hash, m_current_level);
+    hashValue(hash, m_enemy_to_kill);
+    hashValue(hash, m_game_over);
+    hashValue(hash, m_eagle->type);
+    for(auto player : m_players)
+    {
+        hashTank(hash, player);
+        hashValue(hash, player->score);
+    }
+    for(auto player : m_killed_players) hashValue(hash, player->score);
+    for(auto enemy : m_enemies) hashTank(hash, enemy);
+    for(auto bonus : m_bonuses)
+    {
+        hashValue(hash, bonus->type);
+        hashDouble(hash, bonus->pos_x);
+        hashDouble(hash, bonus->pos_y);
+    }
+    for(int i = 0; i < m_level.getRowsCount(); i++)
+        for(int j = 0; j < m_level.getColumnsCount(); j++)
+        {
+            SpriteType type = m_level.getType(i, j);
+            hashValue(hash, type);
+            if(type != ST_NONE) hashRect(hash, m_level.collisionRect(i, j));
+        }
+    hashValue(hash, m_bushes.size());
+    return hash;
+}
+
+void Game::saveSnapshot(Snapshot& snapshot) const
+{
+    snapshot.clear();
+    snapshot.write(m_seed);
+    snapshot.write(m_current_level);
+    snapshot.write(m_player_count);
+    snapshot.write(m_enemy_to_kill);
+    snapshot.write(m_level_start_screen);
+    snapshot.write(m_protect_eagle);
+    snapshot.write(m_level_start_time);
+    snapshot.write(m_enemy_redy_time);
+    snapshot.write(m_level_end_time);
+    snapshot.write(m_protect_eagle_time);
+    snapshot.write(m_game_over);
+    snapshot.write(m_game_over_position);
+    snapshot.write(m_finished);
+    snapshot.write(m_pause);
+    snapshot.write(m_enemy_respown_position);
+
+    m_level.saveState(snapshot);
+
+    snapshot.write(static_cast<Uint32>(m_bushes.size()));
+    for(auto bush : m_bushes)
+    {
+        snapshot.write(static_cast<Sint16>(bush->pos_x));
+        snapshot.write(static_cast<Sint16>(bush->pos_y));
+    }
+
+    m_eagle->saveState(snapshot);
+
+    snapshot.write(static_cast<Uint32>(m_players.size()));
+    for(auto player : m_players) player->saveState(snapshot);
+    snapshot.write(static_cast<Uint32>(m_killed_players.size()));
+    for(auto player : m_killed_players) player->saveState(snapshot);
+    snapshot.write(static_cast<Uint32>(m_enemies.size()));
+    for(auto enemy : m_enemies) enemy->saveState(snapshot);
+    snapshot.write(static_cast<Uint32>(m_bonuses.size()));
+    for(auto bonus : m_bonuses) bonus->saveState(snapshot);
+
+    // the flow fields of players follow their targets only every two fields, so the targets depend on the past and are saved
+    for(auto& field : m_player_fields)
+    {
+        snapshot.write(field.isBuilt());
+        snapshot.write(field.getTarget());
+    }
+
+    // written at the end, creating restored objects may draw random numbers
+    snapshot.write(m_random);
+}
+
+bool Game::restoreSnapshot(const Snapshot& snapshot)
+{
+    SnapshotReader reader(snapshot);
+    reader.read(m_seed);
+    reader.read(m_current_level);
+    reader.read(m_player_count);
+    reader.read(m_enemy_to_kill);
+    reader.read(m_level_start_screen);
+    reader.read(m_protect_eagle);
+    reader.read(m_level_start_time);
+    reader.read(m_enemy_redy_time);
+    reader.read(m_level_end_time);
+    reader.read(m_protect_eagle_time);
+    reader.read(m_game_over);
+    reader.read(m_game_over_position);
+    reader.read(m_finished);
+    reader.read(m_pause);
+    reader.read(m_enemy_respown_position);
+
+    if(!m_level.loadState(reader)) return false;
+
+    Uint32 count = 0;
+    reader.read(count);
+    if(reader.error() || count > snapshot.size()) return false;
+    bool same_bushes = (count == m_bushes.size());
+    std::vector<SDL_Point> bushes(count);
+    for(unsigned i = 0; i < count; i++)
+    {
+        Sint16 x = 0, y = 0;
+        reader.read(x);
+        reader.read(y);
+        bushes[i] = {x, y};
+        if(same_bushes && (m_bushes[i]->pos_x != x || m_bushes[i]->pos_y != y)) same_bushes = false;
+    }
+    if(!same_bushes)
+    {
+        for(auto bush : m_bushes) delete bush;
+        m_bushes.clear();
+        for(auto point : bushes) m_bushes.push_back(new Object(m_engine, point.x, point.y, ST_BUSH));
+    }
+
+    if(m_eagle == nullptr) m_eagle = new Eagle(m_engine);
+    m_eagle->loadState(reader);
+
+    // players can move between the living and the killed ones, so both sets share their objects
+    std::vector<Player*> players = m_players;
+    players.insert(players.end(), m_killed_players.begin(), m_killed_players.end());
+    m_players.clear();
+    m_killed_players.clear();
+    for(int k = 0; k < 2; k++)
+    {
+        std::vector<Player*>& restored = (k == 0 ? m_players : m_killed_players);
+        count = 0;
+        reader.read(count);
+        if(reader.error() || count > snapshot.size()) return false;
+        for(unsigned i = 0; i < count; i++)
+        {
+            Player* player;
+            if(!players.empty())
+            {
+                player = players.back();
+                players.pop_back();
+            }
+            else
+            {
+                player = new Player(m_engine, m_config.get());
+                player->setBulletPool(&m_bullet_pool);
+            }
+            player->loadState(reader);
+            restored.push_back(player);
+        }
+    }
+    for(auto player : players) delete player;
+
+    count = 0;
+    reader.read(count);
+    if(reader.error() || count > snapshot.size()) return false;
+    while(m_enemies.size() > count)
+    {
+        delete m_enemies.back();
+        m_enemies.pop_back();
+    }
+    while(m_enemies.size() < count)
+    {
+        m_enemies.push_back(new Enemy(m_engine, &m_random, m_config.get()));
+        m_enemies.back()->setBulletPool(&m_bullet_pool);
+    }
+    for(auto enemy : m_enemies) enemy->loadState(reader);
+
+    count = 0;
+    reader.read(count);
+    if(reader.error() || count > snapshot.size()) return false;
+    while(m_bonuses.size() > count)
+    {
+        delete m_bonuses.back();
+        m_bonuses.pop_back();
+    }
+    while(m_bonuses.size() < count) m_bonuses.push_back(new Bonus(m_engine, m_config.get()));
+    for(auto bonus : m_bonuses) bonus->loadState(reader);
+
+    // the restored map is new for the flow fields: the field of the eagle is built in the next step, the fields of players now with their saved targets
+    m_eagle_field.clear();
+    for(auto& field : m_player_fields)
+    {
+        bool built = false;
+        SDL_Rect target = {0, 0, 0, 0};
+        reader.read(built);
+        reader.read(target);
+        if(built && !reader.error()) field.build(m_level, target);
+        else field.clear();
+    }
+    m_flow_revision = m_level.getTypesRevision();
+
+    reader.read(m_random);
+    return !reader.error();
+}
+
 void Game::clearLevel()
 {
     for(auto enemy : m_enemies) delete enemy;
@@ -461,15 +889,15 @@ void Game::clearLevel()
     for(auto player : m_players) delete player;
     m_players.clear();
 
+    for(auto player : m_killed_players) delete player;
+    m_killed_players.clear();
+
     for(auto bonus : m_bonuses) delete bonus;
     m_bonuses.clear();
 
-    for(auto row : m_level)
-    {
-        for(auto item : row) if(item != nullptr) delete item;
-        row.clear();
-    }
     m_level.clear();
+    m_eagle_field.clear();
+    for(auto& field : m_player_fields) field.clear();
 
     for(auto bush : m_bushes)  delete bush;
     m_bushes.clear();
@@ -478,6 +906,150 @@ void Game::clearLevel()
     m_eagle = nullptr;
 }
 
+SDL_Rect Game::tankBounds(Tank* tank, Uint32 dt)
+{
+    SDL_Rect current = tank->collision_rect;
+    SDL_Rect next = tank->nextCollisionRect(dt);
+    if(current.w <= 0 || current.h <= 0) return next;
+    if(next.w <= 0 || next.h <= 0) return current;
+
+    SDL_Rect bounds;
+    bounds.x = std::min(current.x, next.x);
+    bounds.y = std::min(current.y, next.y);
+    bounds.w = std::max(current.x + current.w, next.x + next.w) - bounds.x;
+    bounds.h = std::max(current.y + current.h, next.y + next.h) - bounds.y;
+    return bounds;
+}
+
+void Game::buildBroadphase(Uint32 dt)
+{
+    m_player_grid.clear();
+    for(unsigned i = 0; i < m_players.size(); i++)
+        m_player_grid.insert(tankBounds(m_players[i], dt), i);
+    m_player_grid.build();
+
+    m_enemy_grid.clear();
+    m_enemy_bullet_grid.clear();
+    m_enemy_bullet_owners.clear();
+    m_enemy_bullet_rects.clear();
+    for(unsigned i = 0; i < m_enemies.size(); i++)
+    {
+        m_enemy_grid.insert(tankBounds(m_enemies[i], dt), i);
+        for(auto bullet : m_enemies[i]->bullets)
+        {
+            m_enemy_bullet_grid.insert(bullet->collision_rect, m_enemy_bullet_owners.size());
+            m_enemy_bullet_rects.add(bullet->collision_rect);
+            m_enemy_bullet_owners.push_back(i);
+        }
+    }
+    m_enemy_grid.build();
+    m_enemy_bullet_grid.build();
+}
+
+void Game::setEagleWalls(SpriteType type)
+{
+    int rows_count = m_level.getRowsCount();
+    if(rows_count < 3 || m_level.getColumnsCount() < 15) return;
+    for(int i = 0; i < 3; i++)
+    {
+        m_level.set(rows_count - i - 1, 11, type);
+        m_level.set(rows_count - i - 1, 14, type);
+    }
+    for(int i = 12; i < 14; i++)
+        m_level.set(rows_count - 3, i, type);
+}
+
+void Game::updateFlowFields()
+{
+    // a few destroyed walls only repair the fields, they are built again when the whole map changed
+    bool changed = false;
+    if(m_level.getTypesRevision() != m_flow_revision)
+    {
+        m_flow_changes.clear();
+        changed = !m_level.getTypeChanges(m_flow_revision, m_flow_changes);
+        if(!changed)
+        {
+            m_eagle_field.repair(m_level, m_flow_changes);
+            for(auto& field : m_player_fields) field.repair(m_level, m_flow_changes);
+        }
+        m_flow_revision = m_level.getTypesRevision();
+        m_level.forgetTypeChanges();
+    }
+    if(changed || !m_eagle_field.isBuilt()) m_eagle_field.build(m_level, m_eagle->collision_rect);
+
+    // only enemies A and D hunt players
+    if(std::none_of(m_enemies.begin(), m_enemies.end(), [](Enemy* e){return e->type == ST_TANK_A || e->type == ST_TANK_D;})) return;
+    for(auto player : m_players)
+    {
+        // the field is built again when the player moves two fields away from its target, a smaller error does not change the way of enemies
+        SDL_Rect target = player->collision_rect;
+        target.x = (target.x + AppConfig::tile_rect.w / 2) / AppConfig::tile_rect.w * AppConfig::tile_rect.w;
+        target.y = (target.y + AppConfig::tile_rect.h / 2) / AppConfig::tile_rect.h * AppConfig::tile_rect.h;
+        FlowField& field = m_player_fields[player->type == ST_PLAYER_1 ? 0 : 1];
+        const SDL_Rect& old = field.getTarget();
+        if(changed || !field.isBuilt() || abs(old.x - target.x) + abs(old.y - target.y) >= 2 * AppConfig::tile_rect.w)
+            field.build(m_level, target);
+    }
+}
+
+void Game::assignEnemyTargets()
+{
+    const int bullet_width = m_engine->getSpriteConfig()->getSpriteData(ST_BULLET)->rect.w;
+    for(auto enemy : m_enemies)
+    {
+        const FlowField* best = &m_eagle_field;
+        const SDL_Rect* target = &m_eagle->dest_rect;
+        Uint32 min_distance = m_eagle_field.getDistance(enemy->pos_x, enemy->pos_y);
+        if(enemy->type == ST_TANK_A || enemy->type == ST_TANK_D)
+            for(auto player : m_players)
+            {
+                const FlowField* field = &m_player_fields[player->type == ST_PLAYER_1 ? 0 : 1];
+                Uint32 distance = field->getDistance(enemy->pos_x, enemy->pos_y);
+                if(distance < min_distance)
+                {
+                    min_distance = distance;
+                    best = field;
+                    target = &player->dest_rect;
+                }
+            }
+
+        if(min_distance == FlowField::unreachable)
+        {
+            // no field reaches the enemy, e.g. the eagle is surrounded by stone walls
+            best = nullptr;
+            int min_metric = 832; // 2 * 26 * 16
+            int metric;
+            if(enemy->type == ST_TANK_A || enemy->type == ST_TANK_D)
+                for(auto player : m_players)
+                {
+                    metric = fabs(player->dest_rect.x - enemy->dest_rect.x) + fabs(player->dest_rect.y - enemy->dest_rect.y);
+                    if(metric < min_metric)
+                    {
+                        min_metric = metric;
+                        target = &player->dest_rect;
+                    }
+                }
+            metric = fabs(m_eagle->dest_rect.x - enemy->dest_rect.x) + fabs(m_eagle->dest_rect.y - enemy->dest_rect.y);
+            if(metric < min_metric) target = &m_eagle->dest_rect;
+        }
+
+        enemy->target_position = {target->x + target->w / 2, target->y + target->h / 2};
+        enemy->target_field = best;
+
+        // enemies D shoot only when the bullet can reach the target in a straight line
+        enemy->target_in_sight = false;
+        if(enemy->type == ST_TANK_D)
+        {
+            SDL_Point center = {enemy->dest_rect.x + enemy->dest_rect.w / 2, enemy->dest_rect.y + enemy->dest_rect.h / 2};
+            int dx = enemy->target_position.x - center.x, dy = enemy->target_position.y - center.y;
+            if(abs(dx) < enemy->dest_rect.w)
+                enemy->target_in_sight = lineOfSight(center, {center.x, enemy->target_position.y}, bullet_width);
+            else if(abs(dy) < enemy->dest_rect.h)
+                enemy->target_in_sight = lineOfSight(center, {enemy->target_position.x, center.y}, bullet_width);
+        }
+    }
+}
+
 void Game::checkCollisionTankWithLevel(Tank* tank, Uint32 dt)
 {
     if(tank->to_erase) return;
@@ -485,8 +1057,7 @@ void Game::checkCollisionTankWithLevel(Tank* tank, Uint32 dt)
     int row_start, row_end;
     int column_start, column_end;
 
-    SDL_Rect pr, *lr;
-    Object* o;
+    SDL_Rect pr, lr;
 
     //========================collision with map elements========================
     switch(tank->direction)
@@ -518,37 +1089,46 @@ void Game::checkCollisionTankWithLevel(Tank* tank, Uint32 dt)
     }
     if(column_start < 0) column_start = 0;
     if(row_start < 0) row_start = 0;
-    if(column_end >= m_level_columns_count) column_end = m_level_columns_count - 1;
-    if(row_end >= m_level_rows_count) row_end = m_level_rows_count - 1;
+    if(column_end >= m_level.getColumnsCount()) column_end = m_level.getColumnsCount() - 1;
+    if(row_end >= m_level.getRowsCount()) row_end = m_level.getRowsCount() - 1;
 
     pr = tank->nextCollisionRect(dt);
     SDL_Rect intersect_rect;
 
-
+    // all fields around the tank are tested at once
+    m_tile_rects.clear();
+    m_tile_indexes.clear();
     for(int i = row_start; i <= row_end; i++)
         for(int j = column_start; j <= column_end ;j++)
         {
-            if(tank->stop) break;
-            o = m_level.at(i).at(j);
-            if(o == nullptr) continue;
-            if(tank->testFlag(TSF_BOAT) && o->type == ST_WATER) continue;
-
-            lr = &o->collision_rect;
+            SpriteType type = m_level.getType(i, j);
+            if(type == ST_NONE) continue;
+            if(tank->testFlag(TSF_BOAT) && type == ST_WATER) continue;
+            m_tile_rects.add(m_level.collisionRect(i, j));
+            m_tile_indexes.push_back(i * m_level.getColumnsCount() + j);
+        }
+    m_tile_rects.intersect(pr, m_hits);
 
-            intersect_rect = intersectRect(lr, &pr);
-            if(intersect_rect.w > 0 && intersect_rect.h > 0)
-            {
-                if(o->type == ST_ICE)
-                {
-                    if(intersect_rect.w > 10 && intersect_rect.h > 10)
-                       tank->setFlag(TSF_ON_ICE);
-                    continue;
-                }
-                else
-                    tank->collide(intersect_rect);
-                break;
-            }
+    // fields are handled row by row; the first obstacle hit in a row ends that row, ice does not
+    int finished_row = -1;
+    for(unsigned k = 0; k < m_tile_indexes.size(); k++)
+    {
+        if(!RectBatch::hit(m_hits, k)) continue;
+        if(tank->stop) break;
+        int i = m_tile_indexes[k] / m_level.getColumnsCount(), j = m_tile_indexes[k] % m_level.getColumnsCount();
+        if(i == finished_row) continue;
+
+        lr = m_level.collisionRect(i, j);
+        intersect_rect = intersectRect(&lr, &pr);
+        if(m_level.getType(i, j) == ST_ICE)
+        {
+            if(intersect_rect.w > 10 && intersect_rect.h > 10)
+               tank->setFlag(TSF_ON_ICE);
+            continue;
         }
+        tank->collide(intersect_rect);
+        finished_row = i;
+    }
 
     //========================collision with map borders========================
     SDL_Rect outside_map_rect;
@@ -613,74 +1193,110 @@ void Game::checkCollisionBulletWithLevel(Bullet* bullet)
     if(bullet == nullptr) return;
     if(bullet->collide) return;
 
-    int row_start, row_end;
-    int column_start, column_end;
-
-    SDL_Rect* br, *lr;
+    const int tile_w = AppConfig::tile_rect.w, tile_h = AppConfig::tile_rect.h;
+    SDL_Rect* br = &bullet->collision_rect;
+    SDL_Rect lr;
     SDL_Rect intersect_rect;
-    Object* o;
 
     //========================collision with map elements========================
+    // the whole way of the last step is checked: lines of fields (rows or columns) are walked from the line of the front edge
+    // before the step to the line of the front edge now, like a DDA along one axis; the first line with a hit stops the bullet,
+    // so a fast bullet or a long step cannot jump over a thin wall
+    SDL_Rect previous = {(int)bullet->previous_x, (int)bullet->previous_y, br->w, br->h};
+    SDL_Rect swept;
+    swept.x = min(previous.x, br->x);
+    swept.y = min(previous.y, br->y);
+    swept.w = max(previous.x + previous.w, br->x + br->w) - swept.x;
+    swept.h = max(previous.y + previous.h, br->y + br->h) - swept.y;
+
+    bool vertical = (bullet->direction == D_UP || bullet->direction == D_DOWN);
+    int first_line = 0, last_line = 0;
     switch(bullet->direction)
     {
     case D_UP:
-        row_start = row_end = bullet->collision_rect.y / AppConfig::tile_rect.h;
-        column_start = bullet->collision_rect.x / AppConfig::tile_rect.w;
-        column_end = (bullet->collision_rect.x + bullet->collision_rect.w) / AppConfig::tile_rect.w;
+        first_line = previous.y / tile_h;
+        last_line = br->y / tile_h;
         break;
     case D_RIGHT:
-        column_start = column_end = (bullet->collision_rect.x + bullet->collision_rect.w) / AppConfig::tile_rect.w;
-        row_start = bullet->collision_rect.y / AppConfig::tile_rect.h;
-        row_end = (bullet->collision_rect.y + bullet->collision_rect.h) / AppConfig::tile_rect.h;
+        first_line = (previous.x + previous.w) / tile_w;
+        last_line = (br->x + br->w) / tile_w;
         break;
     case D_DOWN:
-        row_start = row_end = (bullet->collision_rect.y + bullet->collision_rect.h)/ AppConfig::tile_rect.h;
-        column_start = bullet->collision_rect.x / AppConfig::tile_rect.w;
-        column_end = (bullet->collision_rect.x + bullet->collision_rect.w) / AppConfig::tile_rect.w;
+        first_line = (previous.y + previous.h) / tile_h;
+        last_line = (br->y + br->h) / tile_h;
         break;
     case D_LEFT:
-        column_start = column_end = bullet->collision_rect.x / AppConfig::tile_rect.w;
-        row_start = bullet->collision_rect.y / AppConfig::tile_rect.h;
-        row_end = (bullet->collision_rect.y + bullet->collision_rect.h) / AppConfig::tile_rect.h;
+        first_line = previous.x / tile_w;
+        last_line = br->x / tile_w;
         break;
     }
-    if(column_start < 0) column_start = 0;
-    if(row_start < 0) row_start = 0;
-    if(column_end >= m_level_columns_count) column_end = m_level_columns_count - 1;
-    if(row_end >= m_level_rows_count) row_end = m_level_rows_count - 1;
+    int step = (last_line < first_line ? -1 : 1);
+    int lines_count = (vertical ? m_level.getRowsCount() : m_level.getColumnsCount());
+
+    // fields across the way, the bullet does not move sideways
+    int across_start = (vertical ? br->x / tile_w : br->y / tile_h);
+    int across_end = (vertical ? (br->x + br->w) / tile_w : (br->y + br->h) / tile_h);
+    if(across_start < 0) across_start = 0;
+    if(across_end >= (vertical ? m_level.getColumnsCount() : m_level.getRowsCount()))
+        across_end = (vertical ? m_level.getColumnsCount() : m_level.getRowsCount()) - 1;
+
+    m_tile_indexes.clear();
+    for(int line = first_line; ; line += step)
+    {
+        if(line >= 0 && line < lines_count)
+            for(int k = across_start; k <= across_end; k++)
+            {
+                int i = (vertical ? line : k), j = (vertical ? k : line);
+                SpriteType type = m_level.getType(i, j);
+                if(type == ST_NONE || type == ST_ICE || type == ST_WATER) continue;
 
-    br = &bullet->collision_rect;
+                lr = m_level.collisionRect(i, j);
+                intersect_rect = intersectRect(&lr, &swept);
+                if(intersect_rect.w > 0 && intersect_rect.h > 0) m_tile_indexes.push_back(i * m_level.getColumnsCount() + j);
+            }
+        if(!m_tile_indexes.empty() || line == last_line) break;
+    }
 
-    for(int i = row_start; i <= row_end; i++)
-        for(int j = column_start; j <= column_end; j++)
+    if(!m_tile_indexes.empty())
+    {
+        // a bullet that passed the wall during the step is moved back to it, so it explodes at the wall
+        bool reached = false;
+        int contact = (bullet->direction == D_UP || bullet->direction == D_LEFT ? INT_MIN : INT_MAX);
+        for(int index : m_tile_indexes)
         {
-            o = m_level.at(i).at(j);
-            if(o == nullptr) continue;
-            if(o->type == ST_ICE || o->type == ST_WATER) continue;
-
-            lr = &o->collision_rect;
-            intersect_rect = intersectRect(lr, br);
-
-            if(intersect_rect.w > 0 && intersect_rect.h > 0)
+            lr = m_level.collisionRect(index / m_level.getColumnsCount(), index % m_level.getColumnsCount());
+            intersect_rect = intersectRect(&lr, br);
+            if(intersect_rect.w > 0 && intersect_rect.h > 0) reached = true;
+            switch(bullet->direction)
             {
-                if(bullet->increased_damage)
-                {
-                    delete o;
-                    m_level.at(i).at(j) = nullptr;
-                }
-                else if(o->type == ST_BRICK_WALL)
-                {
-                    Brick* brick = dynamic_cast<Brick*>(o);
-                    brick->bulletHit(bullet->direction);
-                    if(brick->to_erase)
-                    {
-                        delete brick;
-                        m_level.at(i).at(j) = nullptr;
-                    }
-                }
-                bullet->destroy();
+            case D_UP: contact = max(contact, lr.y + lr.h); break;
+            case D_RIGHT: contact = min(contact, lr.x); break;
+            case D_DOWN: contact = min(contact, lr.y); break;
+            case D_LEFT: contact = max(contact, lr.x + lr.w); break;
             }
         }
+        if(!reached)
+        {
+            switch(bullet->direction)
+            {
+            case D_UP: bullet->pos_y += contact - 1 - br->y; break;
+            case D_RIGHT: bullet->pos_x += contact + 1 - (br->x + br->w); break;
+            case D_DOWN: bullet->pos_y += contact + 1 - (br->y + br->h); break;
+            case D_LEFT: bullet->pos_x += contact - 1 - br->x; break;
+            }
+            bullet->update(0);
+        }
+
+        for(int index : m_tile_indexes)
+        {
+            int i = index / m_level.getColumnsCount(), j = index % m_level.getColumnsCount();
+            if(bullet->increased_damage)
+                m_level.set(i, j, ST_NONE);
+            else if(m_level.getType(i, j) == ST_BRICK_WALL)
+                m_level.bulletHit(i, j, bullet->direction);
+            bullet->destroy();
+        }
+    }
 
     //========================collision with map borders========================
     if(br->x < 0 || br->y < 0 || br->x + br->w > AppConfig::map_rect.w || br->y + br->h > AppConfig::map_rect.h)
@@ -688,9 +1304,10 @@ void Game::checkCollisionBulletWithLevel(Bullet* bullet)
         bullet->destroy();
     }
     //========================collision with the eagle========================
+    // a bullet stopped by a wall is checked where it stopped, another one along its whole way
     if(m_eagle->type == ST_EAGLE && !m_game_over)
     {
-        intersect_rect = intersectRect(&m_eagle->collision_rect, br);
+        intersect_rect = intersectRect(&m_eagle->collision_rect, m_tile_indexes.empty() ? &swept : br);
         if(intersect_rect.w > 0 && intersect_rect.h > 0)
         {
             bullet->destroy();
@@ -729,42 +1346,39 @@ void Game::checkCollisionPlayerBulletsWithEnemy(Player *player, Enemy *enemy)
 {
     if(player->to_erase || enemy->to_erase) return;
     if(enemy->testFlag(TSF_DESTROYED)) return;
-    SDL_Rect intersect_rect;
 
-    for(auto bullet : player->bullets)
+    m_player_bullet_rects.intersect(enemy->collision_rect, m_hits);
+    for(unsigned i = 0; i < player->bullets.size(); i++)
     {
-        if(!bullet->to_erase && !bullet->collide)
+        Bullet* bullet = player->bullets[i];
+        if(RectBatch::hit(m_hits, i) && !bullet->to_erase && !bullet->collide)
         {
-            intersect_rect = intersectRect(&bullet->collision_rect, &enemy->collision_rect);
-            if(intersect_rect.w > 0 && intersect_rect.h > 0)
-            {
-                if(enemy->testFlag(TSF_BONUS)) generateBonus();
+            if(enemy->testFlag(TSF_BONUS)) generateBonus();
 
-                bullet->destroy();
-                enemy->destroy();
-                if(enemy->lives_count <= 0) m_enemy_to_kill--;
-                player->score += enemy->scoreForHit();
-            }
+            bullet->destroy();
+            enemy->destroy();
+            if(enemy->lives_count <= 0) m_enemy_to_kill--;
+            player->score += enemy->scoreForHit();
+            // a destroyed tank has an empty collision rectangle, so the other bullets miss it
+            if(enemy->testFlag(TSF_DESTROYED)) break;
         }
     }
 }
 
-void Game::checkCollisionEnemyBulletsWithPlayer(Enemy *enemy, Player *player)
+void Game::checkCollisionEnemyBulletsWithPlayer(Enemy *enemy, Player *player, const std::vector<Uint32>& hits, unsigned first)
 {
     if(enemy->to_erase || player->to_erase) return;
     if(player->testFlag(TSF_DESTROYED)) return;
-    SDL_Rect intersect_rect;
 
-    for(auto bullet : enemy->bullets)
+    for(unsigned i = 0; i < enemy->bullets.size(); i++)
     {
-        if(!bullet->to_erase && !bullet->collide)
+        Bullet* bullet = enemy->bullets[i];
+        if(RectBatch::hit(hits, first + i) && !bullet->to_erase && !bullet->collide)
         {
-            intersect_rect = intersectRect(&bullet->collision_rect, &player->collision_rect);
-            if(intersect_rect.w > 0 && intersect_rect.h > 0)
-            {
-                bullet->destroy();
-                player->destroy();
-            }
+            bullet->destroy();
+            player->destroy();
+            // a destroyed tank has an empty collision rectangle, so the other bullets miss it
+            if(player->testFlag(TSF_DESTROYED)) break;
         }
     }
 }
@@ -816,22 +1430,7 @@ void Game::checkCollisionPlayerWithBonus(Player *player, Bonus *bonus)
         {
             m_protect_eagle = true;
             m_protect_eagle_time = 0;
-            for(int i = 0; i < 3; i++)
-            {
-                if(m_level.at(m_level_rows_count - i - 1).at(11) != nullptr)
-                    delete m_level.at(m_level_rows_count - i - 1).at(11);
-                m_level.at(m_level_rows_count - i - 1).at(11) = new Object(11 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1) * AppConfig::tile_rect.h, ST_STONE_WALL);
-
-                if(m_level.at(m_level_rows_count - i - 1).at(14) != nullptr)
-                    delete m_level.at(m_level_rows_count - i - 1).at(14);
-                m_level.at(m_level_rows_count - i - 1).at(14) = new Object(14 * AppConfig::tile_rect.w, (m_level_rows_count - i - 1)  * AppConfig::tile_rect.h, ST_STONE_WALL);
-            }
-            for(int i = 12; i < 14; i++)
-            {
-                if(m_level.at(m_level_rows_count - 3).at(i) != nullptr)
-                    delete m_level.at(m_level_rows_count - 3).at(i);
-                m_level.at(m_level_rows_count - 3).at(i) = new Object(i * AppConfig::tile_rect.w, (m_level_rows_count - 3) * AppConfig::tile_rect.h, ST_STONE_WALL);
-            }
+            setEagleWalls(ST_STONE_WALL);
         }
         else if(bonus->type == ST_BONUS_TANK)
         {
@@ -863,7 +1462,7 @@ void Game::nextLevel()
     m_level_start_time = 0;
     m_game_over = false;
     m_finished = false;
-    m_enemy_to_kill = AppConfig::enemy_start_count;
+    m_enemy_to_kill = m_config->enemy_start_count;
 
     std::string level_path = AppConfig::levels_path + Engine::intToString(m_current_level);
     loadLevel(level_path);
@@ -872,18 +1471,21 @@ void Game::nextLevel()
     {
         if(m_player_count == 2)
         {
-            Player* p1 = new Player(AppConfig::player_starting_point.at(0).x, AppConfig::player_starting_point.at(0).y, ST_PLAYER_1);
-            Player* p2 = new Player(AppConfig::player_starting_point.at(1).x, AppConfig::player_starting_point.at(1).y, ST_PLAYER_2);
+            Player* p1 = new Player(m_engine, m_config->player_starting_point.at(0).x, m_config->player_starting_point.at(0).y, ST_PLAYER_1, m_config.get());
+            Player* p2 = new Player(m_engine, m_config->player_starting_point.at(1).x, m_config->player_starting_point.at(1).y, ST_PLAYER_2, m_config.get());
             p1->player_keys = AppConfig::player_keys.at(0);
             p2->player_keys = AppConfig::player_keys.at(1);
+            p1->setBulletPool(&m_bullet_pool);
+            p2->setBulletPool(&m_bullet_pool);
             m_players.push_back(p1);
             m_players.push_back(p2);
 
         }
         else
         {
-            Player* p1 = new Player(AppConfig::player_starting_point.at(0).x, AppConfig::player_starting_point.at(0).y, ST_PLAYER_1);
+            Player* p1 = new Player(m_engine, m_config->player_starting_point.at(0).x, m_config->player_starting_point.at(0).y, ST_PLAYER_1, m_config.get());
             p1->player_keys = AppConfig::player_keys.at(0);
+            p1->setBulletPool(&m_bullet_pool);
             m_players.push_back(p1);
         }
     }
@@ -891,11 +1493,12 @@ void Game::nextLevel()
 
 void Game::generateEnemy()
 {
-    float p = static_cast<float>(rand()) / RAND_MAX;
-    SpriteType type = static_cast<SpriteType>(p < (0.00735 * m_current_level + 0.09265) ? ST_TANK_D : rand() % (ST_TANK_C - ST_TANK_A + 1) + ST_TANK_A);
-    Enemy* e = new Enemy(AppConfig::enemy_starting_point.at(m_enemy_respown_position).x, AppConfig::enemy_starting_point.at(m_enemy_respown_position).y, type);
+    float p = m_random.nextFloat();
+    SpriteType type = static_cast<SpriteType>(p < (0.00735 * m_current_level + 0.09265) ? ST_TANK_D : m_random.nextInt(ST_TANK_C - ST_TANK_A + 1) + ST_TANK_A);
+    Enemy* e = new Enemy(m_engine, m_config->enemy_starting_point.at(m_enemy_respown_position).x, m_config->enemy_starting_point.at(m_enemy_respown_position).y, type, &m_random, m_config.get());
+    e->setBulletPool(&m_bullet_pool);
     m_enemy_respown_position++;
-    if(m_enemy_respown_position >= AppConfig::enemy_starting_point.size()) m_enemy_respown_position = 0;
+    if(m_enemy_respown_position >= m_config->enemy_starting_point.size()) m_enemy_respown_position = 0;
 
     double a, b, c;
     if(m_current_level <= 17)
@@ -911,13 +1514,13 @@ void Game::generateEnemy()
         c = -0.036111 * m_current_level + 1.363889;
     }
 
-    p = static_cast<float>(rand()) / RAND_MAX;
+    p = m_random.nextFloat();
     if(p < a) e->lives_count = 1;
     else if(p < b) e->lives_count = 2;
     else if(p < c) e->lives_count = 3;
     else e->lives_count = 4;
 
-    p = static_cast<float>(rand()) / RAND_MAX;
+    p = m_random.nextFloat();
     if(p < 0.12) e->setFlag(TSF_BONUS);
 
     m_enemies.push_back(e);
@@ -925,12 +1528,12 @@ void Game::generateEnemy()
 
 void Game::generateBonus()
 {
-    Bonus* b = new Bonus(0, 0, static_cast<SpriteType>(rand() % (ST_BONUS_BOAT - ST_BONUS_GRENADE + 1) + ST_BONUS_GRENADE));
+    Bonus* b = new Bonus(m_engine, 0, 0, static_cast<SpriteType>(m_random.nextInt(ST_BONUS_BOAT - ST_BONUS_GRENADE + 1) + ST_BONUS_GRENADE), m_config.get());
     SDL_Rect intersect_rect;
     do
     {
-        b->pos_x = rand() % (AppConfig::map_rect.x + AppConfig::map_rect.w - 1 *  AppConfig::tile_rect.w);
-        b->pos_y = rand() % (AppConfig::map_rect.y + AppConfig::map_rect.h - 1 * AppConfig::tile_rect.h);
+        b->pos_x = m_random.nextInt(AppConfig::map_rect.x + AppConfig::map_rect.w - 1 *  AppConfig::tile_rect.w);
+        b->pos_y = m_random.nextInt(AppConfig::map_rect.y + AppConfig::map_rect.h - 1 * AppConfig::tile_rect.h);
         b->update(0);
         intersect_rect = intersectRect(&b->collision_rect, &m_eagle->collision_rect);
     }while(intersect_rect.w > 0 && intersect_rect.h > 0);
@@ -5,9 +5,15 @@
 #include "../objects/player.h"
 #include "../objects/enemy.h"
 #include "../objects/bullet.h"
-#include "../objects/brick.h"
 #include "../objects/eagle.h"
 #include "../objects/bonus.h"
+#include "../objects/level.h"
+#include "../objects/flowfield.h"
+#include "../engine/random.h"
+#include "../engine/spatialhash.h"
+#include "../engine/rectbatch.h"
+#include "../sim/replay.h"
+#include "../gameconfig.h"
 #include <vector>
 #include <string>
 
@@ -18,22 +24,37 @@ class Game : public AppState
 {
 public:
     /**
-     * Default constructor - allows for single player game
+     * Default constructor - allows for single player game with the rules of @a GameConfig::defaults
+     * @param engine - context of the session, shared with the objects of the game and the following states
      */
-    Game();
+    Game(Engine* engine);
     /**
      * Constructor that allows specifying the initial number of players. The number of players can be 1 or 2, any other value will start the game for one player.
      * This constructor is called in @a Menu::nextState.
+     * @param engine - context of the session, shared with the objects of the game and the following states
      * @param players_count - number of players 1 or 2
+     * @param seed - initial value of the random number generator of the game; the same seed and the same player input give the same game
+     * @param start_level - number of the first level, used by the headless simulation to start from any stage
+     * @param config - rules of the game, shared with its objects and the following levels
      */
-    Game(int players_count);
+    Game(Engine* engine, int players_count, Uint64 seed, int start_level = 1, GameConfigPtr config = GameConfig::defaults());
     /**
      * Constructor that takes already existing players.
      * Called in @a Score::nextState
+     * @param engine - context of the session, the same as of the players
      * @param players - container with players
      * @param previous_level - variable storing the number of the previous level
+     * @param seed - initial value of the random number generator of the game
+     * @param config - rules of the game, the players are switched to them
      */
-    Game(std::vector<Player*> players, int previous_level);
+    Game(Engine* engine, std::vector<Player*> players, int previous_level, Uint64 seed, GameConfigPtr config = GameConfig::defaults());
+    /**
+     * Constructor starting the playback of a recorded level. The players are steered by the recorded controls until the recording ends.
+     * @param engine - context of the session
+     * @param replay - recording with the seed, the level, the starting progress of players and their controls
+     * @param config - rules of the game, the same as in the recorded game
+     */
+    Game(Engine* engine, const Replay& replay, GameConfigPtr config = GameConfig::defaults());
 
     ~Game();
     /**
@@ -45,11 +66,14 @@ public:
      * At the beginning of the round, the function displays its number. During the game, the function is responsible for drawing the level (walls, stones, water, ice, bushes),
      * players, enemies, bonuses, the eagle, game status on the right panel (remaining enemies, remaining lives of players, round number).
      * After a loss or during a pause, it displays the corresponding information in the middle of the screen.
+     * Nothing is drawn if the context has no renderer.
      */
     void draw();
     /**
      * The function updates the state of all objects on the board (tanks, bonuses, obstacles). It also checks collisions between tanks, between tanks and level elements, and between bullets and tanks and map elements.
      * Here, destroyed objects are removed, new enemy tanks are added, and the conditions for ending the round are checked.
+     * In fast forward (see @a setTimeScale) one call makes several steps of length @a dt, each exactly like a step at normal speed.
+     * A @a dt longer than @a maxStepTime is split into equal steps not longer than the limit.
      * @param dt - time since the last function call in milliseconds
      */
     void update(Uint32 dt);
@@ -69,6 +93,117 @@ public:
      */
     AppState* nextState();
 
+    /**
+     * @return @a true if the eagle was destroyed or all players lost their lives
+     */
+    bool isGameOver() const;
+    /**
+     * @return @a true during the start screen of the level and while waiting for the end of the level after the last enemy was killed;
+     * nothing can be played then, so the waits may be simulated as fast as possible
+     */
+    bool isWaiting() const;
+    /**
+     * Setting the number of simulation steps made by one call of @a update, shown in the status panel.
+     * @param scale - 1 for normal speed, e.g. 10 or 100 for fast forward, 0 if the caller updates the game as fast as possible; @a update makes one step then
+     */
+    void setTimeScale(unsigned scale);
+    /**
+     * @return speed set with @a setTimeScale
+     */
+    unsigned getTimeScale() const;
+    /**
+     * @return number of the current level
+     */
+    int getCurrentLevel() const;
+    /**
+     * @return number of remaining enemies to kill on the current level
+     */
+    int getEnemyToKill() const;
+    /**
+     * @return sum of points of all players, including the killed ones
+     */
+    unsigned getScore() const;
+    /**
+     * @return players that are still in the game
+     */
+    const std::vector<Player*>& getPlayers() const;
+    /**
+     * @return enemies currently on the map
+     */
+    const std::vector<Enemy*>& getEnemies() const;
+    /**
+     * @return the eagle object
+     */
+    const Eagle* getEagle() const;
+    /**
+     * @return bonuses currently on the map
+     */
+    const std::vector<Bonus*>& getBonuses() const;
+    /**
+     * @return bushes of the map, drawn above tanks
+     */
+    const std::vector<Object*>& getBushes() const;
+    /**
+     * @return rules of the game
+     */
+    const GameConfig& getConfig() const;
+    /**
+     * @return map of the current level
+     */
+    const Level& getLevel() const;
+    /**
+     * @return bullets shared by all tanks of the game, with counters of used bullets
+     */
+    const BulletPool& getBulletPool() const;
+    /**
+     * Checking whether a bullet flying between two points on one row or one column of pixels would hit a wall.
+     * Every row and column of fields crossed by the bullet is checked with a few word operations of the map.
+     * @param from - starting point on the map, e.g. the middle of a tank
+     * @param to - end point with the same horizontal or the same vertical position as @a from
+     * @param thickness - width of the bullet across its way
+     * @return @a true if no brick or stone wall lies between the points, @a false also for points not on a common row or column
+     */
+    bool lineOfSight(const SDL_Point& from, const SDL_Point& to, int thickness) const;
+    /**
+     * Steering the player's tank by a bot or a replay instead of the keyboard. The controls stay in effect until the next call.
+     * @param player_index - 0 for the first player, 1 for the second
+     * @param input - combination of @a PlayerInputFlag values
+     */
+    void setPlayerInput(int player_index, PlayerInputs input);
+    /**
+     * Starting the recording of the players' controls. It has to be called before the first @a update.
+     * @param dt - length of the simulation step passed to @a update
+     */
+    void startRecording(Uint32 dt);
+    /**
+     * @return recording of the current level, finished with the checksum of the last step
+     */
+    const Replay& getReplay();
+    /**
+     * @return @a true if the game plays back a recording
+     */
+    bool isReplaying() const;
+    /**
+     * The function calculates a hash of the simulation state: positions, directions and lives of tanks, bullets, bonuses, the map and counters.
+     * Two games give the same checksum only if they went through the same states, which is used to verify replays.
+     * @return 64-bit FNV-1a hash
+     */
+    Uint64 checksum() const;
+    /**
+     * Saving the whole state of the game: the map with damage of brick walls, bushes, the eagle, players, enemies with their bullets,
+     * bonuses, the targets of the flow fields of players, all timers and the random number generator. Restoring the snapshot and giving the same controls gives the same game,
+     * so it can be used for rewinding, checkpoints and restarting a level without loading it again.
+     * The snapshot keeps its memory, so saving every step does not allocate. The recording of a replay is not saved.
+     * @param snapshot - buffer overwritten with the state of the game
+     */
+    void saveSnapshot(Snapshot& snapshot) const;
+    /**
+     * Restoring the state saved by @a saveSnapshot of this or another game. Existing objects are reused, missing ones are created.
+     * @param snapshot - state of the game
+     * @return @a false if the snapshot is damaged, in that case the state of the game is undefined
+     */
+    bool restoreSnapshot(const Snapshot& snapshot);
+
 private:
     /**
      * Load the level map from a file
@@ -79,6 +214,18 @@ private:
      * Removing remaining enemies, players, map objects, and bonuses
      */
     void clearLevel();
+    /**
+     * Longest step simulated without changing its outcome. Only collisions of bullets with walls and the eagle are swept along the way of a step,
+     * bullets with bullets and tanks are tested at its end, so a bullet may not fly further than its own size in one step, or two bullets
+     * flying at each other could pass through each other.
+     * @return length of the step in milliseconds, at most @a AppConfig::sim_max_tick_time
+     */
+    Uint32 maxStepTime() const;
+    /**
+     * One step of the simulation, see @a update.
+     * @param dt - length of the step in milliseconds, at most @a maxStepTime
+     */
+    void step(Uint32 dt);
     /**
      * Load a new level and create new players if they do not already exist.
      * @see Game::loadLevel(std::string path)
@@ -95,7 +242,34 @@ private:
      * The function generates a random bonus on the map and places it in a position that does not collide with the eagle.
      */
     void generateBonus();
+    /**
+     * Surrounding the eagle with walls of the given type, used by the Shovel bonus.
+     * @param type - @a ST_STONE_WALL during the protection, @a ST_BRICK_WALL after it
+     */
+    void setEagleWalls(SpriteType type);
 
+    /**
+     * The function returns the rectangle covering the tank now and after the next move, used by the broad phase of collision detection.
+     * @param tank - checked tank
+     * @param dt - length of the next move
+     * @return union of @a Tank::collision_rect and @a Tank::nextCollisionRect
+     */
+    static SDL_Rect tankBounds(Tank* tank, Uint32 dt);
+    /**
+     * Filling the grids of the broad phase with players, enemies and enemy bullets. Called once per step before collisions are checked.
+     * @param dt - length of the next move
+     */
+    void buildBroadphase(Uint32 dt);
+    /**
+     * Building the flow field of the eagle again when obstacles changed and the flow fields of players when they moved two fields away.
+     * Flow fields of players are updated only if there are enemies hunting them.
+     */
+    void updateFlowFields();
+    /**
+     * Choosing the target of every enemy: the eagle or, for enemies A and D, the nearest player, measured by the flow fields.
+     * If no flow field reaches the enemy, the distance on the map is used.
+     */
+    void assignEnemyTargets();
     /**
      * Check if the tank can freely move forward, if not, it stops. The function prevents leaving the play area.
      * If the tank enters ice, it causes it to slide. If the tank has the "Boat" bonus, it can cross water. Tanks cannot cross the eagle.
@@ -124,6 +298,7 @@ private:
     void checkCollisionBulletWithBush(Bullet* bullet);
     /**
      * Check if a player has hit a selected enemy. If so, the player scores points and the enemy loses one armor level.
+     * All bullets of the player are tested against the enemy at once, they have to be in @a m_player_bullet_rects.
      * @param player - player
      * @param enemy - enemy
      */
@@ -132,8 +307,10 @@ private:
      * Check if an enemy bullet has hit a player. If so, the player loses one life unless they had a shield.
      * @param enemy - enemy
      * @param player - player
+     * @param hits - bullets of all enemies in @a m_enemy_bullet_rects intersecting the player
+     * @param first - index of the first bullet of the enemy in @a m_enemy_bullet_rects
      */
-    void checkCollisionEnemyBulletsWithPlayer(Enemy* enemy, Player* player);
+    void checkCollisionEnemyBulletsWithPlayer(Enemy* enemy, Player* player, const std::vector<Uint32>& hits, unsigned first);
     /**
      * If two bullets collide, both are destroyed.
      * @param bullet1
@@ -157,17 +334,58 @@ private:
     void checkCollisionPlayerWithBonus(Player* player, Bonus* bonus);
 
     /**
-     * Number of columns in the map grid.
+     * Context of the session: animations of objects and the renderer.
+     */
+    Engine* m_engine;
+    /**
+     * Rules of the game, the objects of the game keep pointers to it.
      */
-    int m_level_columns_count;
+    GameConfigPtr m_config;
     /**
-     * Number of rows in the map grid.
+     * Random number generator used for all random decisions in the game: enemy types, armor, bonuses and enemy movement.
      */
-    int m_level_rows_count;
+    Random m_random;
+    /**
+     * Initial value of @a m_random.
+     */
+    Uint64 m_seed;
+    /**
+     * Recording of the current level, written if @a m_recording is set or played if @a m_replaying is set.
+     */
+    Replay m_replay;
+    /**
+     * Variable stores whether the players' controls are recorded in every step.
+     */
+    bool m_recording;
+    /**
+     * Variable stores whether the players are steered by @a m_replay.
+     */
+    bool m_replaying;
+    /**
+     * Bullets of all tanks of the game.
+     */
+    BulletPool m_bullet_pool;
     /**
      * Obstacles on the map.
      */
-    std::vector< std::vector <Object*> > m_level;
+    Level m_level;
+    /**
+     * Distances to the eagle used by enemies.
+     */
+    FlowField m_eagle_field;
+    /**
+     * Distances to the first and the second player used by enemies A and D.
+     */
+    FlowField m_player_fields[2];
+    /**
+     * Revision of the map for which the flow fields were built or repaired.
+     * @see Level::getTypesRevision
+     */
+    Uint32 m_flow_revision;
+    /**
+     * Fields of the map changed since @a m_flow_revision, kept between updates to avoid allocations.
+     */
+    std::vector<int> m_flow_changes;
     /**
      * Bushes on the map.
      */
@@ -248,10 +466,71 @@ private:
      * Variable indicates whether pause has been activated.
      */
     bool m_pause;
+    /**
+     * Number of simulation steps made by one call of @a update, 0 for the simulation as fast as possible.
+     */
+    unsigned m_time_scale;
+    /**
+     * Variable stores whether the paths to targets of enemies are drawn, switched with T.
+     */
+    bool m_show_enemy_target;
+    /**
+     * Variable stores whether the numbers of draw calls and sprites of the last frame are shown in the status panel, switched with I.
+     */
+    bool m_show_draw_stats;
     /**
      * Position number for newly created enemy. Changed with each enemy creation.
      */
     int m_enemy_respown_position;
+
+    /**
+     * Broad phase grid with players, identifiers are indexes in @a m_players.
+     */
+    SpatialHash m_player_grid;
+    /**
+     * Broad phase grid with enemies, identifiers are indexes in @a m_enemies.
+     */
+    SpatialHash m_enemy_grid;
+    /**
+     * Broad phase grid with bullets of enemies, identifiers are indexes in @a m_enemy_bullet_owners.
+     */
+    SpatialHash m_enemy_bullet_grid;
+    /**
+     * Index in @a m_enemies of the enemy that fired each bullet in @a m_enemy_bullet_grid.
+     */
+    std::vector<int> m_enemy_bullet_owners;
+    /**
+     * Collision rectangles of bullets of enemies in the order of @a m_enemy_bullet_owners, every player is tested against all of them at once.
+     */
+    RectBatch m_enemy_bullet_rects;
+    /**
+     * Bullets of enemies hitting each player, results of @a RectBatch::intersect indexed like @a m_players.
+     */
+    std::vector<std::vector<Uint32>> m_player_hits;
+    /**
+     * Collision rectangles of bullets of the player whose collisions are being checked.
+     */
+    RectBatch m_player_bullet_rects;
+    /**
+     * Collision rectangles of fields around the tank whose collisions are being checked.
+     */
+    RectBatch m_tile_rects;
+    /**
+     * Indexes of the fields in @a m_tile_rects, or of the fields hit by a bullet in @a checkCollisionBulletWithLevel.
+     */
+    std::vector<int> m_tile_indexes;
+    /**
+     * Result of a single @a RectBatch::intersect, kept between steps to avoid allocations.
+     */
+    std::vector<Uint32> m_hits;
+    /**
+     * Objects found by the broad phase, kept between steps to avoid allocations.
+     */
+    std::vector<int> m_candidates;
+    /**
+     * Result of a single broad phase query.
+     */
+    std::vector<int> m_query;
 };
 
 #endif // GAME_H
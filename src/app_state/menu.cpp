@@ -6,14 +6,17 @@
 #include "../app_state/game.h"
 
 #include <iostream>
+#include <ctime>
 
-Menu::Menu()
+Menu::Menu(Engine* engine, GameConfigPtr config)
 {
+    m_engine = engine;
+    m_config = config;
     m_menu_texts.push_back("1 Player");
     m_menu_texts.push_back("2 Players");
     m_menu_texts.push_back("Exit");
     m_menu_index = 0;
-    m_tank_pointer = new Player(0, 0 , ST_PLAYER_1);
+    m_tank_pointer = new Player(m_engine, 0, 0, ST_PLAYER_1, m_config.get());
     m_tank_pointer->direction = D_RIGHT;
     m_tank_pointer->pos_x = 144;
     m_tank_pointer->pos_y = (m_menu_index + 1) * 32 + 112;
@@ -32,14 +35,15 @@ Menu::~Menu()
 
 void Menu::draw()
 {
-    Renderer* renderer = Engine::getEngine().getRenderer();
+    Renderer* renderer = m_engine->getRenderer();
+    if(renderer == nullptr) return;
     renderer->clear();
 
     renderer->drawRect(&AppConfig::map_rect, {0, 0, 0, 255}, true);
     renderer->drawRect(&AppConfig::status_rect, {0, 0, 0, 255}, true);
 
     //LOGO
-    const SpriteData* logo = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_TANKS_LOGO);
+    const SpriteData* logo = m_engine->getSpriteConfig()->getSpriteData(ST_TANKS_LOGO);
     SDL_Rect dst = {(AppConfig::map_rect.w + AppConfig::status_rect.w - logo->rect.w)/2, 50, logo->rect.w, logo->rect.h};
     renderer->drawObject(&logo->rect, &dst);
 
@@ -107,12 +111,12 @@ AppState* Menu::nextState()
         return nullptr;
     else if(m_menu_index == 0)
     {
-        Game* g = new Game(1);
+        Game* g = new Game(m_engine, 1, time(NULL), 1, m_config);
         return g;
     }
     else if(m_menu_index == 1)
     {
-        Game* g = new Game(2);
+        Game* g = new Game(m_engine, 2, time(NULL), 1, m_config);
         return g;
     }
     return nullptr;
@@ -3,6 +3,7 @@
 
 #include "appstate.h"
 #include "../objects/player.h"
+#include "../gameconfig.h"
 
 #include <vector>
 #include <string>
@@ -13,7 +14,12 @@
 class Menu : public AppState
 {
 public:
-    Menu();
+    /**
+     * Creating the menu.
+     * @param engine - context of the session, passed to the started games
+     * @param config - rules of the games started from the menu
+     */
+    Menu(Engine* engine, GameConfigPtr config = GameConfig::defaults());
     ~Menu();
     /**
      * Function checking whether to end the menu state and proceed to the next game state.
@@ -22,6 +28,7 @@ public:
     bool finished() const;
     /**
      * Function draws the game logo, menu entries, and the selected position indicator in the shape of a tank.
+     * Nothing is drawn if the context has no renderer.
      */
     void draw();
     /**
@@ -57,6 +64,14 @@ private:
      * Variable responsible for the indicator in the form of a tank.
      */
     Player* m_tank_pointer;
+    /**
+     * Context of the session.
+     */
+    Engine* m_engine;
+    /**
+     * Rules of the games started from the menu.
+     */
+    GameConfigPtr m_config;
     /**
      * Variable stores information on whether to end the current game state and proceed to the game or shut down the application.
      */
@@ -4,19 +4,25 @@
 #include "game.h"
 #include "menu.h"
 
-Scores::Scores()
+Scores::Scores(Engine* engine)
 {
+    m_engine = engine;
+    m_config = GameConfig::defaults();
     m_show_time = 0;
     m_level = 0;
     m_game_over = true;
     m_score_counter_run = true;
     m_score_counter = 0;
     m_max_score = 0;
+    m_seed = 0;
 }
 
-Scores::Scores(std::vector<Player *> players, int level, bool game_over)
+Scores::Scores(Engine* engine, std::vector<Player *> players, int level, bool game_over, Uint64 seed, GameConfigPtr config)
 {
+    m_engine = engine;
+    m_config = config;
     m_players = players;
+    m_seed = seed;
     m_level = level;
     m_game_over = game_over;
     m_show_time = 0;
@@ -37,7 +43,8 @@ Scores::Scores(std::vector<Player *> players, int level, bool game_over)
 
 void Scores::draw()
 {
-    Renderer* renderer = Engine::getEngine().getRenderer();
+    Renderer* renderer = m_engine->getRenderer();
+    if(renderer == nullptr) return;
     renderer->clear();
 
     renderer->drawRect(&AppConfig::map_rect, {0, 0, 0, 255}, true);
@@ -115,9 +122,9 @@ AppState *Scores::nextState()
 {
     if(m_game_over)
     {
-        Menu* m = new Menu;
+        Menu* m = new Menu(m_engine, m_config);
         return m;
     }
-    Game* g = new Game(m_players, m_level);
+    Game* g = new Game(m_engine, m_players, m_level, m_seed, m_config);
     return g;
 }
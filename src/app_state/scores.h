@@ -2,6 +2,7 @@
 #define SCORES_H
 #include "appstate.h"
 #include "../objects/player.h"
+#include "../gameconfig.h"
 
 #include <vector>
 #include <string>
@@ -13,14 +14,21 @@
 class Scores : public AppState
 {
 public:
-    Scores();
+    /**
+     * Creating an empty score screen followed by the menu.
+     * @param engine - context of the session
+     */
+    Scores(Engine* engine);
     /**
      * Constructor called by Game after the game ends.
+     * @param engine - context of the session, the same as of the players
      * @param players - container with all players who participated in the game
      * @param level - number of the last level
      * @param game_over - variable indicating whether the last level was lost
+     * @param seed - initial value of the random number generator for the next level
+     * @param config - rules of the game, used by the players and passed to the next level
      */
-    Scores(std::vector<Player*> players, int level, bool game_over);
+    Scores(Engine* engine, std::vector<Player*> players, int level, bool game_over, Uint64 seed, GameConfigPtr config);
     /**
      * The function returns @a true after a specified time of displaying the score screen.
      * @return @a true or @a false
@@ -28,6 +36,7 @@ public:
     bool finished() const;
     /**
      * The function is responsible for drawing the appropriate texts and players' tanks on the screen.
+     * Nothing is drawn if the context has no renderer.
      */
     void draw();
     /**
@@ -51,6 +60,14 @@ private:
      * Container with all players (killed and not killed).
      */
     std::vector<Player*> m_players;
+    /**
+     * Context of the session.
+     */
+    Engine* m_engine;
+    /**
+     * Rules of the game, they have to exist as long as the players.
+     */
+    GameConfigPtr m_config;
     /**
      * Number of the last level.
      */
@@ -75,6 +92,10 @@ private:
      * Time since the end of score counting in milliseconds.
      */
     Uint32 m_show_time;
+    /**
+     * Initial value of the random number generator passed to the next level.
+     */
+    Uint64 m_seed;
 };
 
 #endif // SCORES_H
@@ -18,6 +18,8 @@ enum sound_type {
 
 /**
  * @brief a class that contains a set of application parameters.
+ * The layout of the board and the lengths of simulation steps are constants shared by all games, also on different threads;
+ * the rules of a game are in @a GameConfig.
  */
 class AppConfig
 {
@@ -34,6 +36,10 @@ public:
      * font path.
      */
     static string font_name;
+    /**
+     * path to the description of a different sprite sheet, empty for the built-in animations of the texture.
+     */
+    static string sprites_path;
     /**
      * displayed after a loss.
      */
@@ -41,11 +47,11 @@ public:
     /**
      * dimensions of the game board.
      */
-    static SDL_Rect map_rect;
+    static const SDL_Rect map_rect;
     /**
      * dimensions and location relative to the game status area board.
      */
-    static SDL_Rect status_rect;
+    static const SDL_Rect status_rect;
     /**
      * application window size.
      */
@@ -53,93 +59,34 @@ public:
     /**
      * cell size on the board.
      */
-    static SDL_Rect tile_rect;
-    /**
-     * two starting positions of players.
-     */
-    static vector<SDL_Point> player_starting_point;
-    /**
-     * three starting positions of enemies.
-     */
-    static vector<SDL_Point> enemy_starting_point;
+    static const SDL_Rect tile_rect;
     /**
      * controlling players' tanks.
      */
     static vector <Player::PlayerKeys> player_keys;
-    /**
-     * time displayed and number of the round at its start.
-     */
-    static unsigned level_start_time;
-    /**
-     * duration of slip on ice in milliseconds.
-     */
-    static unsigned slip_time;
-    /**
-     * number of enemies to kill in one round.
-     */
-    static unsigned enemy_start_count;
-    /**
-     * the time after which a new enemy may appear on the map in milliseconds.
-     */
-    static unsigned enemy_redy_time;
-    /**
-     * default maximum number of shells a player can fire.
-     */
-    static unsigned player_bullet_max_size;
     /**
      * Time to show results after the countdown in milliseconds is completed.
      */
-    static unsigned score_show_time;
-    /**
-     * the length of time the bonus is visible on the map in milliseconds.
-     */
-    static unsigned bonus_show_time;
-    /**
-     * casing operating time in milliseconds.
-     */
-    static unsigned tank_shield_time;
-    /**
-     * the length of time enemies are frozen in milliseconds.
-     */
-    static unsigned tank_frozen_time;
-    /**
-     * Time between killing all enemies and going to the result window in milliseconds.
-     */
-    static unsigned level_end_time;
-    /**
-     * duration of the stone casing around the eagle in milliseconds.
-     */
-    static unsigned protect_eagle_time;
-    /**
-     * bonus flashing time in milliseconds.
-     */
-    static unsigned bonus_blink_time;
-    /**
-     * Minimum time between the player firing projectiles in milliseconds.
-     */
-    static unsigned player_reload_time;
-    /**
-     * maximum number of tanks on the map in one moment.
-     */
-    static int enemy_max_count_on_map;
+    static const unsigned score_show_time;
     /**
-     * speed of movement napsu game over.
+     * length of one simulation step in milliseconds; the game state is always updated with this fixed time step.
      */
-    static double game_over_entry_speed;
+    static const unsigned sim_tick_time;
     /**
-     * nominal tank speed.
+     * maximum number of simulation steps computed before one frame is drawn; if the simulation falls further behind, the rest of the lag is dropped.
      */
-    static double tank_default_speed;
+    static const unsigned sim_max_ticks_per_frame;
     /**
-     * nominal projectile velocity.
+     * longest simulation step in milliseconds; @a Game::update splits longer steps, because in a longer step a tank could move further
+     * than the fields checked around it. Fast bullets lower the limit of a game, see @a Game::maxStepTime.
      */
-    static double bullet_default_speed;
+    static const unsigned sim_max_tick_time;
     /**
-     * The variable stores information about whether showing enemy targets has been enabled.
+     * longest time in milliseconds spent on the simulation before a frame is drawn in fast forward, so frames are still drawn at the display rate.
      */
-    static bool show_enemy_target;
+    static const unsigned sim_frame_budget;
     /**
-     * Sound effect
+     * Sound effect; entries stay @a nullptr when the audio is not initialized (headless mode).
      */
     static Mix_Chunk* sounds[SND_MAX];
 };
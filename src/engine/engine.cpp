@@ -7,10 +7,9 @@ Engine::Engine()
     m_sprite_config = nullptr;
 }
 
-Engine &Engine::getEngine()
+Engine::~Engine()
 {
-    static Engine engine;
-    return engine;
+    destroyModules();
 }
 
 std::string Engine::intToString(int num)
@@ -29,9 +28,9 @@ std::string Engine::intToString(int num)
     return buf;
 }
 
-void Engine::initModules()
+void Engine::initModules(bool with_renderer)
 {
-    m_renderer = new Renderer;
+    if(with_renderer) m_renderer = new Renderer;
     m_sprite_config = new SpriteConfig;
 }
 
@@ -5,17 +5,25 @@
 #include "spriteconfig.h"
 
 /**
- * @brief The class connects elements related to the operation of the program.
+ * @brief
+ * Context of one session of the game, passed to the states of the application and to the objects of the game.
+ * It has two parts: the simulation part, @a SpriteConfig with the sizes and animations of objects, needed by every game,
+ * and the render part, @a Renderer, which exists only in a window. A game simulated without a window uses a context
+ * without the renderer; drawing does nothing then.
+ *
+ * Contexts are independent, so sessions can be played on different threads, each with its own context.
+ * One context can also be shared by games on many threads as long as its sprite configuration is not loaded again.
  */
 class Engine
 {
 public:
     Engine();
-
     /**
-     * @return a static instance of the @a Engine object
+     * Destroying the component objects if @a destroyModules was not called.
      */
-    static Engine& getEngine(); // the engine can be accessible in any module by using only the namespace, not a pointer
+    ~Engine();
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
     /**
      * The function converts the given numerical value to text.
      * @param num - an integer
@@ -23,16 +31,17 @@ public:
      */
     static std::string intToString(int num);
     /**
-     * The function creates component objects of the engine.
+     * The function creates component objects of the engine. The context has to be initialized before it is passed to games and objects.
+     * @param with_renderer - @a false skips creating the @a Renderer, so the game can be simulated without a window (headless mode)
      */
-    void initModules();
+    void initModules(bool with_renderer = true);
     /**
      * The function destroys component objects of the engine.
      */
     void destroyModules();
 
     /**
-     * @return a pointer to the Renderer object allowing drawing on the screen
+     * @return a pointer to the Renderer object allowing drawing on the screen; @a nullptr in headless mode
      */
     Renderer* getRenderer() const;
     /**
@@ -0,0 +1,50 @@
+#include "random.h"
+
+static inline Uint32 rotl(Uint32 x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+Random::Random(Uint64 seed)
+{
+    this->seed(seed);
+}
+
+void Random::seed(Uint64 seed)
+{
+    // expand the seed with splitmix64 to fill the whole state
+    for(int i = 0; i < 4; i += 2)
+    {
+        Uint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+        m_state[i] = static_cast<Uint32>(z);
+        m_state[i + 1] = static_cast<Uint32>(z >> 32);
+    }
+}
+
+Uint32 Random::next()
+{
+    const Uint32 result = rotl(m_state[1] * 5, 7) * 9;
+    const Uint32 t = m_state[1] << 9;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotl(m_state[3], 11);
+
+    return result;
+}
+
+Uint32 Random::nextInt(Uint32 n)
+{
+    return static_cast<Uint32>((static_cast<Uint64>(next()) * n) >> 32);
+}
+
+float Random::nextFloat()
+{
+    return (next() >> 8) * (1.0f / 16777216.0f);
+}
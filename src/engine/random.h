@@ -0,0 +1,46 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <SDL2/SDL_stdinc.h>
+
+/**
+ * @brief
+ * Small and fast pseudo-random number generator (xoshiro128**) with 128 bits of state.
+ * Every game owns its own generator, so games started with the same seed make identical decisions
+ * and several games can be simulated on different threads at the same time.
+ */
+class Random
+{
+public:
+    /**
+     * Creating a generator.
+     * @param seed - initial value of the generator
+     */
+    Random(Uint64 seed = 0);
+    /**
+     * Restarting the generator. Two generators with the same seed return the same sequence of numbers.
+     * @param seed - initial value of the generator
+     */
+    void seed(Uint64 seed);
+    /**
+     * @return next 32-bit pseudo-random number
+     */
+    Uint32 next();
+    /**
+     * @param n - upper limit, has to be greater than zero
+     * @return pseudo-random integer from the range [0, n)
+     */
+    Uint32 nextInt(Uint32 n);
+    /**
+     * @return pseudo-random floating point number from the range [0, 1)
+     */
+    float nextFloat();
+
+private:
+    /**
+     * State of the generator.
+     */
+    Uint32 m_state[4];
+};
+
+#endif // RANDOM_H
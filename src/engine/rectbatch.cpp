@@ -0,0 +1,99 @@
+#include "rectbatch.h"
+#include <climits>
+
+// MSVC does not define __SSE2__, but every 64-bit processor has SSE2
+#if defined(__AVX2__)
+#define RECTBATCH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RECTBATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * Number of rectangles the padded arrays are a multiple of, the width of the widest vector.
+ */
+static const unsigned batch_padding = 8;
+
+RectBatch::RectBatch()
+{
+    m_size = 0;
+}
+
+void RectBatch::clear()
+{
+    m_left.clear();
+    m_top.clear();
+    m_right.clear();
+    m_bottom.clear();
+    m_size = 0;
+}
+
+void RectBatch::add(const SDL_Rect& rect)
+{
+    // a new group of padding rectangles is added when the previous one is used up
+    if(m_size % batch_padding == 0)
+    {
+        m_left.resize(m_size + batch_padding, INT_MAX);
+        m_top.resize(m_size + batch_padding, INT_MAX);
+        m_right.resize(m_size + batch_padding, INT_MIN);
+        m_bottom.resize(m_size + batch_padding, INT_MIN);
+    }
+    // rectangles with no area stay padding, they cannot intersect anything
+    if(rect.w > 0 && rect.h > 0)
+    {
+        m_left[m_size] = rect.x;
+        m_top[m_size] = rect.y;
+        m_right[m_size] = rect.x + rect.w;
+        m_bottom[m_size] = rect.y + rect.h;
+    }
+    m_size++;
+}
+
+void RectBatch::intersect(const SDL_Rect& rect, std::vector<Uint32>& mask) const
+{
+    mask.assign((m_size + 31) / 32, 0);
+    if(rect.w <= 0 || rect.h <= 0) return;
+    const int left = rect.x, top = rect.y, right = rect.x + rect.w, bottom = rect.y + rect.h;
+    const unsigned count = m_left.size();
+
+#if defined(RECTBATCH_AVX2)
+    const __m256i l = _mm256_set1_epi32(left), t = _mm256_set1_epi32(top), r = _mm256_set1_epi32(right), b = _mm256_set1_epi32(bottom);
+    for(unsigned i = 0; i < count; i += 8)
+    {
+        __m256i x = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)&m_right[i]), l);
+        x = _mm256_and_si256(x, _mm256_cmpgt_epi32(r, _mm256_loadu_si256((const __m256i*)&m_left[i])));
+        __m256i y = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)&m_bottom[i]), t);
+        y = _mm256_and_si256(y, _mm256_cmpgt_epi32(b, _mm256_loadu_si256((const __m256i*)&m_top[i])));
+        Uint32 bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(x, y)));
+        mask[i / 32] |= bits << (i % 32);
+    }
+#elif defined(RECTBATCH_SSE2)
+    const __m128i l = _mm_set1_epi32(left), t = _mm_set1_epi32(top), r = _mm_set1_epi32(right), b = _mm_set1_epi32(bottom);
+    for(unsigned i = 0; i < count; i += 4)
+    {
+        __m128i x = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&m_right[i]), l);
+        x = _mm_and_si128(x, _mm_cmpgt_epi32(r, _mm_loadu_si128((const __m128i*)&m_left[i])));
+        __m128i y = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&m_bottom[i]), t);
+        y = _mm_and_si128(y, _mm_cmpgt_epi32(b, _mm_loadu_si128((const __m128i*)&m_top[i])));
+        Uint32 bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(x, y)));
+        mask[i / 32] |= bits << (i % 32);
+    }
+#else
+    for(unsigned i = 0; i < m_size; i++)
+        if(left < m_right[i] && m_left[i] < right && top < m_bottom[i] && m_top[i] < bottom)
+            mask[i / 32] |= Uint32(1) << (i % 32);
+    (void)count;
+#endif
+}
+
+const char* RectBatch::kernelName()
+{
+#if defined(RECTBATCH_AVX2)
+    return "AVX2";
+#elif defined(RECTBATCH_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
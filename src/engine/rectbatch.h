@@ -0,0 +1,73 @@
+#ifndef RECTBATCH_H
+#define RECTBATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+/**
+ * @brief
+ * Rectangles packed into four arrays of coordinates: left, top, right and bottom edges, so one rectangle can be tested
+ * against all of them at once. The test compares several rectangles with one vector instruction: eight with AVX2, four with SSE2,
+ * chosen when the program is compiled (e.g. with -mavx2); other processors use a plain loop. The arrays are padded
+ * with rectangles that intersect nothing up to a multiple of eight, so the vector loops need no remainder.
+ * Rectangles intersect in the same cases as @a intersectRect gives a positive width and height, so rectangles with no area never intersect.
+ */
+class RectBatch
+{
+public:
+    RectBatch();
+
+    /**
+     * Removing all rectangles, the memory of the arrays is kept.
+     */
+    void clear();
+    /**
+     * Adding a rectangle at the end of the batch, its index is the previous size.
+     * @param rect - added rectangle
+     */
+    void add(const SDL_Rect& rect);
+    /**
+     * @return number of added rectangles
+     */
+    unsigned size() const { return m_size; }
+    /**
+     * Testing a rectangle against all rectangles of the batch.
+     * @param rect - tested rectangle
+     * @param mask - overwritten with one bit per rectangle of the batch, bit i of word i / 32 is set if rectangle i intersects @a rect
+     */
+    void intersect(const SDL_Rect& rect, std::vector<Uint32>& mask) const;
+    /**
+     * @param mask - result of @a intersect
+     * @param index - index of a rectangle in the batch
+     * @return @a true if the bit of the rectangle is set
+     */
+    static bool hit(const std::vector<Uint32>& mask, unsigned index) { return (mask[index / 32] >> (index % 32)) & 1; }
+    /**
+     * @return name of the instruction set used by @a intersect: "AVX2", "SSE2" or "scalar"
+     */
+    static const char* kernelName();
+
+private:
+    /**
+     * Left edges.
+     */
+    std::vector<int> m_left;
+    /**
+     * Top edges.
+     */
+    std::vector<int> m_top;
+    /**
+     * Right edges: left edge plus width.
+     */
+    std::vector<int> m_right;
+    /**
+     * Bottom edges: top edge plus height.
+     */
+    std::vector<int> m_bottom;
+    /**
+     * Number of added rectangles, the arrays may be longer because of the padding.
+     */
+    unsigned m_size;
+};
+
+#endif // RECTBATCH_H
@@ -7,10 +7,22 @@
 Renderer::Renderer()
 {
     m_texture = nullptr;
+    m_texture_size = {0, 0};
     m_renderer = nullptr;
-    m_text_texture = nullptr;
-    m_font1 = nullptr;
-    m_font2 = nullptr;
+    m_layer_texture = nullptr;
+    m_layer_size = {0, 0};
+    m_draw_calls = 0;
+    m_frame_draw_calls = 0;
+    m_sprites = 0;
+    m_frame_sprites = 0;
+    m_batch_texture = nullptr;
+    for(auto& atlas : m_fonts)
+    {
+        atlas.texture = nullptr;
+        atlas.size = {0, 0};
+        atlas.height = 0;
+        for(auto& glyph : atlas.glyphs) glyph = {0, 0, 0, 0};
+    }
 }
 
 Renderer::~Renderer()
@@ -19,14 +31,11 @@ Renderer::~Renderer()
         SDL_DestroyRenderer(m_renderer);
     if(m_texture != nullptr)
         SDL_DestroyTexture(m_texture);
-    if(m_text_texture != nullptr)
-        SDL_DestroyTexture(m_text_texture);
-    if(m_font1 != nullptr)
-        TTF_CloseFont(m_font1);
-    if(m_font2 != nullptr)
-        TTF_CloseFont(m_font2);
-    if(m_font3 != nullptr)
-        TTF_CloseFont(m_font3);
+    if(m_layer_texture != nullptr)
+        SDL_DestroyTexture(m_layer_texture);
+    for(auto& atlas : m_fonts)
+        if(atlas.texture != nullptr)
+            SDL_DestroyTexture(atlas.texture);
 }
 
 void Renderer::loadTexture(SDL_Window* window)
@@ -39,31 +48,133 @@ void Renderer::loadTexture(SDL_Window* window)
     //load surface
     if(surface != nullptr && m_renderer != nullptr)
         m_texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    if(m_texture != nullptr)
+        SDL_QueryTexture(m_texture, nullptr, nullptr, &m_texture_size.x, &m_texture_size.y);
 
     SDL_FreeSurface(surface);
 }
 
 void Renderer::loadFont()
 {
-    m_font1 = TTF_OpenFont(AppConfig::font_name.c_str(), 28);
-    m_font2 = TTF_OpenFont(AppConfig::font_name.c_str(), 14);
-    m_font3 = TTF_OpenFont(AppConfig::font_name.c_str(), 10);
+    const int sizes[3] = {28, 14, 10};
+    for(int i = 0; i < 3; i++)
+    {
+        TTF_Font* font = TTF_OpenFont(AppConfig::font_name.c_str(), sizes[i]);
+        if(font == nullptr) continue;
+        buildFontAtlas(m_fonts[i], font);
+        TTF_CloseFont(font);
+    }
+}
+
+void Renderer::buildFontAtlas(FontAtlas& atlas, TTF_Font* font)
+{
+    const int glyphs_count = sizeof(atlas.glyphs) / sizeof(atlas.glyphs[0]);
+    const int columns_count = 16;
+
+    // the font has no kerning, so characters rendered one by one look the same as the whole text rendered at once
+    SDL_Surface* glyphs[glyphs_count];
+    char text[2] = {0, 0};
+    int cell_w = 0, cell_h = 0;
+    for(int i = 0; i < glyphs_count; i++)
+    {
+        text[0] = ' ' + i;
+        glyphs[i] = TTF_RenderText_Solid(font, text, {255, 255, 255, 255});
+        if(glyphs[i] == nullptr) continue;
+        cell_w = max(cell_w, glyphs[i]->w);
+        cell_h = max(cell_h, glyphs[i]->h);
+    }
+
+    SDL_Surface* surface = nullptr;
+    if(cell_w > 0 && cell_h > 0)
+        surface = SDL_CreateRGBSurfaceWithFormat(0, columns_count * cell_w, (glyphs_count + columns_count - 1) / columns_count * cell_h, 32, SDL_PIXELFORMAT_RGBA32);
+    for(int i = 0; i < glyphs_count; i++)
+    {
+        if(glyphs[i] == nullptr) continue;
+        atlas.glyphs[i] = {i % columns_count * cell_w, i / columns_count * cell_h, glyphs[i]->w, glyphs[i]->h};
+        SDL_Rect dest = atlas.glyphs[i];
+        if(surface != nullptr) SDL_BlitSurface(glyphs[i], nullptr, surface, &dest);
+        SDL_FreeSurface(glyphs[i]);
+    }
+    if(surface == nullptr) return;
+
+    atlas.height = cell_h;
+    atlas.size = {surface->w, surface->h};
+    atlas.texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    SDL_FreeSurface(surface);
 }
 
 void Renderer::clear()
 {
+    flushBatch();
     SDL_SetRenderDrawColor(m_renderer, 110, 110, 110, 255);
     SDL_RenderClear(m_renderer); //Clear the back buffer
 }
 
 void Renderer::flush()
 {
+    flushBatch();
     SDL_RenderPresent(m_renderer); //Swap buffers
+    m_frame_draw_calls = m_draw_calls;
+    m_frame_sprites = m_sprites;
+    m_draw_calls = 0;
+    m_sprites = 0;
 }
 
 void Renderer::drawObject(const SDL_Rect *texture_src, const SDL_Rect *window_dest)
 {
-    SDL_RenderCopy(m_renderer, m_texture, texture_src, window_dest); //Draw on the back buffer
+    drawSprite(texture_src, window_dest);
+}
+
+void Renderer::drawSprite(const SDL_Rect* texture_src, const SDL_Rect* window_dest, SDL_Color color_mod)
+{
+    if(m_texture == nullptr) return;
+    SDL_Rect src = texture_src != nullptr ? *texture_src : SDL_Rect{0, 0, m_texture_size.x, m_texture_size.y};
+    SDL_Rect dest = window_dest != nullptr ? *window_dest : AppConfig::map_rect;
+    addQuad(m_texture, m_texture_size, src, dest, color_mod);
+}
+
+void Renderer::flushBatch()
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if(m_batch_vertices.empty()) return;
+
+    int indices_count = m_batch_vertices.size() / 4 * 6;
+    while((int)m_batch_indices.size() < indices_count)
+    {
+        int first = m_batch_indices.size() / 6 * 4;
+        const int corners[6] = {0, 1, 2, 0, 2, 3};
+        for(int corner : corners) m_batch_indices.push_back(first + corner);
+    }
+    SDL_RenderGeometry(m_renderer, m_batch_texture, m_batch_vertices.data(), m_batch_vertices.size(), m_batch_indices.data(), indices_count);
+    m_draw_calls++;
+    m_batch_vertices.clear();
+#endif
+    m_batch_texture = nullptr;
+}
+
+void Renderer::addQuad(SDL_Texture* texture, SDL_Point texture_size, const SDL_Rect& src, const SDL_Rect& dest, SDL_Color color)
+{
+    m_sprites++;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if(texture != m_batch_texture) flushBatch();
+    m_batch_texture = texture;
+
+    float x1 = dest.x, x2 = dest.x + dest.w;
+    float y1 = dest.y, y2 = dest.y + dest.h;
+    float u1 = (float)src.x / texture_size.x, u2 = (float)(src.x + src.w) / texture_size.x;
+    float v1 = (float)src.y / texture_size.y, v2 = (float)(src.y + src.h) / texture_size.y;
+    m_batch_vertices.push_back({{x1, y1}, color, {u1, v1}});
+    m_batch_vertices.push_back({{x2, y1}, color, {u2, v1}});
+    m_batch_vertices.push_back({{x2, y2}, color, {u2, v2}});
+    m_batch_vertices.push_back({{x1, y2}, color, {u1, v2}});
+#else
+    // older SDL has no geometry rendering, so every rectangle is copied separately
+    (void)texture_size;
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    SDL_RenderCopy(m_renderer, texture, &src, &dest);
+    m_draw_calls++;
+#endif
 }
 
 void Renderer::setScale(float xs, float ys)
@@ -83,48 +194,115 @@ void Renderer::setScale(float xs, float ys)
     SDL_RenderSetViewport(m_renderer, &viewport);
 }
 
-void Renderer::drawText(const SDL_Point* start, string text, SDL_Color text_color, int font_size)
+void Renderer::drawText(const SDL_Point* start, const string& text, SDL_Color text_color, int font_size)
 {
-    if(m_font1 == nullptr || m_font2 == nullptr || m_font3 == nullptr) return;
-    if(m_text_texture != nullptr)
-        SDL_DestroyTexture(m_text_texture);
-
-    SDL_Surface* text_surface = nullptr;
-    if(font_size == 2) text_surface = TTF_RenderText_Solid(m_font2, text.c_str(), text_color);
-    else if(font_size == 3) text_surface = TTF_RenderText_Solid(m_font3, text.c_str(), text_color);
-    else text_surface = TTF_RenderText_Solid(m_font1, text.c_str(), text_color);
+    const FontAtlas& atlas = m_fonts[font_size == 2 ? 1 : (font_size == 3 ? 2 : 0)];
+    if(atlas.texture == nullptr) return;
 
-    if(text_surface == nullptr) return;
-
-    m_text_texture = SDL_CreateTextureFromSurface(m_renderer, text_surface);
-    if(m_text_texture == nullptr) return;
+    int text_w = 0;
+    for(char c : text) text_w += getGlyph(atlas, c).w;
 
     SDL_Rect window_dest;
     if(start == nullptr)
     {
-        window_dest.x = (AppConfig::map_rect.w + AppConfig::status_rect.w - text_surface->w)/2;
-        window_dest.y = (AppConfig::map_rect.h - text_surface->h)/2;
+        window_dest.x = (AppConfig::map_rect.w + AppConfig::status_rect.w - text_w)/2;
+        window_dest.y = (AppConfig::map_rect.h - atlas.height)/2;
     }
     else
     {
-        if(start->x < 0) window_dest.x = (AppConfig::map_rect.w + AppConfig::status_rect.w - text_surface->w)/2;
+        if(start->x < 0) window_dest.x = (AppConfig::map_rect.w + AppConfig::status_rect.w - text_w)/2;
         else window_dest.x = start->x;
 
-        if(start->y < 0) window_dest.y = (AppConfig::map_rect.h - text_surface->h)/2;
+        if(start->y < 0) window_dest.y = (AppConfig::map_rect.h - atlas.height)/2;
         else window_dest.y = start->y;
     }
-    window_dest.w = text_surface->w;
-    window_dest.h = text_surface->h;
 
-    SDL_RenderCopy(m_renderer, m_text_texture, NULL, &window_dest);
+    SDL_Rect dest = {window_dest.x, window_dest.y, 0, 0};
+    for(char c : text)
+    {
+        const SDL_Rect& glyph = getGlyph(atlas, c);
+        dest.w = glyph.w;
+        dest.h = glyph.h;
+        if(glyph.w > 0) addQuad(atlas.texture, atlas.size, glyph, dest, text_color);
+        dest.x += glyph.w;
+    }
+}
+
+const SDL_Rect& Renderer::getGlyph(const FontAtlas& atlas, char c)
+{
+    // characters outside printable ASCII are drawn as spaces
+    unsigned index = (unsigned char)c - ' ';
+    return atlas.glyphs[index < sizeof(atlas.glyphs) / sizeof(atlas.glyphs[0]) ? index : 0];
 }
 
 void Renderer::drawRect(const SDL_Rect *rect, SDL_Color rect_color, bool fill)
 {
+    flushBatch();
     SDL_SetRenderDrawColor(m_renderer, rect_color.r, rect_color.g, rect_color.b, rect_color.a);
 
     if(fill)
         SDL_RenderFillRect(m_renderer, rect);
     else
         SDL_RenderDrawRects(m_renderer, rect, 1);
+    m_draw_calls++;
+}
+
+bool Renderer::beginLayer(int w, int h, bool& created)
+{
+    created = false;
+    flushBatch();
+    if(m_renderer == nullptr || !SDL_RenderTargetSupported(m_renderer)) return false;
+
+    if(m_layer_texture != nullptr && (m_layer_size.x != w || m_layer_size.y != h)) resetLayer();
+    if(m_layer_texture == nullptr)
+    {
+        m_layer_texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+        if(m_layer_texture == nullptr) return false;
+        SDL_SetTextureBlendMode(m_layer_texture, SDL_BLENDMODE_BLEND);
+        m_layer_size = {w, h};
+        created = true;
+    }
+
+    // the window buffer keeps its viewport and scale, they are restored by endLayer
+    return SDL_SetRenderTarget(m_renderer, m_layer_texture) == 0;
+}
+
+void Renderer::endLayer()
+{
+    flushBatch();
+    SDL_SetRenderTarget(m_renderer, nullptr);
+}
+
+void Renderer::clearLayer(const SDL_Rect* rect)
+{
+    flushBatch();
+    SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(m_renderer, rect);
+}
+
+void Renderer::drawLayer(const SDL_Rect* window_dest)
+{
+    if(m_layer_texture == nullptr) return;
+    flushBatch();
+    SDL_RenderCopy(m_renderer, m_layer_texture, nullptr, window_dest);
+    m_draw_calls++;
+}
+
+void Renderer::resetLayer()
+{
+    if(m_layer_texture != nullptr)
+        SDL_DestroyTexture(m_layer_texture);
+    m_layer_texture = nullptr;
+    m_layer_size = {0, 0};
+}
+
+unsigned Renderer::getDrawCallsCount() const
+{
+    return m_frame_draw_calls;
+}
+
+unsigned Renderer::getSpritesCount() const
+{
+    return m_frame_sprites;
 }
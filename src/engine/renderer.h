@@ -4,6 +4,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <string>
+#include <vector>
 
 /**
  * @brief
@@ -20,7 +21,8 @@ public:
      */
     void loadTexture(SDL_Window* window);
     /**
-     * Loading the font in three different sizes.
+     * Loading the font in three different sizes and rendering all printable ASCII characters of every size into a glyph atlas texture.
+     * Drawing text later only copies characters from the atlases.
      */
     void loadFont();
     /**
@@ -35,8 +37,23 @@ public:
      * Redrawing a part of the texture onto a part of the screen buffer.
      * @param texture_src - source rectangle from the texture
      * @param window_dest - target rectangle on the screen buffer
+     * @see drawSprite
      */
     void drawObject(const SDL_Rect *texture_src, const SDL_Rect *window_dest);
+    /**
+     * Adding a part of the texture to the sprite batch. Sprites are not drawn immediately: consecutive sprites are collected
+     * and drawn together with one call when something else is drawn, the drawing target changes or the frame is presented,
+     * so the order of drawing is kept.
+     * @param texture_src - source rectangle from the texture
+     * @param window_dest - target rectangle on the screen buffer
+     * @param color_mod - color multiplied with the texture, white draws the texture unchanged
+     */
+    void drawSprite(const SDL_Rect* texture_src, const SDL_Rect* window_dest, SDL_Color color_mod = {255, 255, 255, 255});
+    /**
+     * Drawing the collected sprites and text characters. It is called by the other drawing methods, so it is needed only
+     * before drawing with SDL functions directly.
+     */
+    void flushBatch();
     /**
      * Setting the scale of the displayed buffer, so that it maintains the proportions of the board and is positioned in the center of the application window.
      * @param xs - horizontal scale as the ratio of window width to map width
@@ -45,13 +62,15 @@ public:
      */
     void setScale(float xs, float ys);
     /**
-     * Drawing text in the window buffer at a selected starting position.
+     * Drawing text in the window buffer at a selected starting position. Characters are added to the batch from the glyph atlas of the font,
+     * so consecutive texts of the same size are drawn with one call.
+     * Characters missing in the atlas are drawn as spaces.
      * @param start - position of the starting point of the drawn text; a negative value of any coordinate results in centering the text on that axis
      * @param text - text to draw
      * @param text_color - color of the drawn text
      * @param font_size - font number with which the text will be drawn; three values available: 1, 2, 3
      */
-    void drawText(const SDL_Point* start, std::string text, SDL_Color text_color, int font_size = 1);
+    void drawText(const SDL_Point* start, const std::string& text, SDL_Color text_color, int font_size = 1);
     /**
      * Function drawing a rectangle in the window buffer.
      * @param rect - position of the rectangle on the board
@@ -60,7 +79,88 @@ public:
      */
     void drawRect(const SDL_Rect* rect, SDL_Color rect_color, bool fill = false);
 
+    /**
+     * Redirecting drawing to the layer texture, which keeps its content between frames. The layer is created on the first call
+     * and again when its size changes or its content was lost. Coordinates inside the layer are not scaled.
+     * @param w - width of the layer
+     * @param h - height of the layer
+     * @param created - set to @a true if the layer was created and its whole content has to be drawn
+     * @return @a false if the renderer does not support drawing to textures, drawing is not redirected then
+     */
+    bool beginLayer(int w, int h, bool& created);
+    /**
+     * Redirecting drawing back to the window buffer.
+     */
+    void endLayer();
+    /**
+     * Making a part of the layer transparent, used before drawing a changed part again.
+     * @param rect - cleared rectangle, @a nullptr clears the whole layer
+     */
+    void clearLayer(const SDL_Rect* rect);
+    /**
+     * Drawing the whole layer onto the window buffer with a single copy.
+     * @param window_dest - target rectangle on the screen buffer
+     */
+    void drawLayer(const SDL_Rect* window_dest);
+    /**
+     * Deleting the layer texture, e.g. after the renderer reported that the content of target textures was lost.
+     */
+    void resetLayer();
+    /**
+     * @return number of draw calls in the last presented frame, including the ones drawn into the layer; a batch of sprites counts as one call
+     */
+    unsigned getDrawCallsCount() const;
+    /**
+     * @return number of sprites and text characters drawn in the last presented frame
+     */
+    unsigned getSpritesCount() const;
+
 private:
+    /**
+     * Texture with all printable ASCII characters of one font size.
+     */
+    struct FontAtlas
+    {
+        /**
+         * Texture with white characters, they are coloured when drawn.
+         */
+        SDL_Texture* texture;
+        /**
+         * Size of the texture.
+         */
+        SDL_Point size;
+        /**
+         * Height of a line of text.
+         */
+        int height;
+        /**
+         * Position of every character in the texture, the width is the distance to the next character.
+         */
+        SDL_Rect glyphs[95];
+    };
+
+    /**
+     * Rendering the characters of a font into an atlas.
+     * @param atlas - filled atlas
+     * @param font - opened font of one size
+     */
+    void buildFontAtlas(FontAtlas& atlas, TTF_Font* font);
+    /**
+     * @param atlas - atlas of the font
+     * @param c - drawn character
+     * @return position and size of the character in the atlas texture
+     */
+    static const SDL_Rect& getGlyph(const FontAtlas& atlas, char c);
+    /**
+     * Adding a textured rectangle to the batch. The batch is drawn first if it uses another texture.
+     * @param texture - source texture
+     * @param texture_size - size of the source texture
+     * @param src - source rectangle from the texture
+     * @param dest - target rectangle
+     * @param color - color multiplied with the texture
+     */
+    void addQuad(SDL_Texture* texture, SDL_Point texture_size, const SDL_Rect& src, const SDL_Rect& dest, SDL_Color color);
+
     /**
      * Pointer to the object associated with the window buffer.
      */
@@ -70,21 +170,51 @@ private:
      */
     SDL_Texture* m_texture;
     /**
-     * Pointer to the auxiliary texture for drawing text on the screen.
+     * Size of the texture with game elements.
+     */
+    SDL_Point m_texture_size;
+    /**
+     * Pointer to the layer texture, @a nullptr if it was not created yet.
+     */
+    SDL_Texture* m_layer_texture;
+    /**
+     * Size of the layer texture.
+     */
+    SDL_Point m_layer_size;
+    /**
+     * Number of draw calls in the current frame.
+     */
+    unsigned m_draw_calls;
+    /**
+     * Number of draw calls in the last presented frame.
+     */
+    unsigned m_frame_draw_calls;
+    /**
+     * Number of sprites drawn in the current frame.
+     */
+    unsigned m_sprites;
+    /**
+     * Number of sprites drawn in the last presented frame.
+     */
+    unsigned m_frame_sprites;
+    /**
+     * Glyph atlases of the font of size 28, 14 and 10.
      */
-    SDL_Texture* m_text_texture;
+    FontAtlas m_fonts[3];
     /**
-     * Font of size 28.
+     * Texture of the collected rectangles, @a nullptr if the batch is empty.
      */
-    TTF_Font* m_font1;
+    SDL_Texture* m_batch_texture;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
     /**
-     * Font of size 14.
+     * Corners of the collected rectangles, the buffer is kept between frames to avoid allocations.
      */
-    TTF_Font* m_font2;
+    std::vector<SDL_Vertex> m_batch_vertices;
     /**
-     * Font of size 10.
+     * Two triangles for every collected rectangle. Indices depend only on the number of rectangles, so they are only appended.
      */
-    TTF_Font* m_font3;
+    std::vector<int> m_batch_indices;
+#endif
 };
 
 #endif // RENDERER_H
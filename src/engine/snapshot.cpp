@@ -0,0 +1,65 @@
+#include "snapshot.h"
+
+Snapshot::Snapshot()
+{
+    m_size = 0;
+}
+
+void Snapshot::clear()
+{
+    m_size = 0;
+}
+
+void Snapshot::writeBytes(const void *data, size_t size)
+{
+    if(size == 0) return;
+    if(m_size + size > m_data.size()) m_data.resize(2 * (m_size + size));
+    memcpy(&m_data[m_size], data, size);
+    m_size += size;
+}
+
+void Snapshot::assign(const Uint8 *data, size_t size)
+{
+    if(size > m_data.size()) m_data.resize(size);
+    if(size > 0) memcpy(&m_data[0], data, size);
+    m_size = size;
+}
+
+const Uint8* Snapshot::data() const
+{
+    return m_data.data();
+}
+
+size_t Snapshot::size() const
+{
+    return m_size;
+}
+
+SnapshotReader::SnapshotReader(const Snapshot &snapshot)
+{
+    m_data = snapshot.data();
+    m_size = snapshot.size();
+    m_position = 0;
+    m_error = false;
+}
+
+bool SnapshotReader::error() const
+{
+    return m_error;
+}
+
+void SnapshotReader::readBytes(void *data, size_t size)
+{
+    if(m_position + size > m_size)
+    {
+        m_error = true;
+        return;
+    }
+    if(size > 0) memcpy(data, m_data + m_position, size);
+    m_position += size;
+}
+
+size_t SnapshotReader::remaining() const
+{
+    return m_size - m_position;
+}
@@ -0,0 +1,123 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <SDL2/SDL_stdinc.h>
+#include <vector>
+#include <cstring>
+
+/**
+ * @brief
+ * Flat buffer storing the saved state of a game. Values are copied byte by byte and the buffer contains no pointers,
+ * so it can be copied with memcpy, written to a file or restored in another process running the same build.
+ * The buffer keeps its memory between saves, so saving a game every step does not allocate.
+ */
+class Snapshot
+{
+public:
+    Snapshot();
+    /**
+     * Removing the saved data without releasing the memory.
+     */
+    void clear();
+    /**
+     * Appending a value of a trivially copyable type.
+     * @param value - saved value
+     */
+    template<typename T> void write(const T& value)
+    {
+        if(m_size + sizeof(T) > m_data.size()) m_data.resize(2 * (m_size + sizeof(T)));
+        memcpy(&m_data[m_size], &value, sizeof(T));
+        m_size += sizeof(T);
+    }
+    /**
+     * Appending an array of bytes, e.g. a whole array of trivially copyable values.
+     * @param data - saved bytes
+     * @param size - number of bytes
+     */
+    void writeBytes(const void* data, size_t size);
+    /**
+     * Replacing the content of the buffer, e.g. with data read from a file.
+     * @param data - saved state
+     * @param size - number of bytes
+     */
+    void assign(const Uint8* data, size_t size);
+    /**
+     * @return pointer to the saved bytes
+     */
+    const Uint8* data() const;
+    /**
+     * @return number of saved bytes
+     */
+    size_t size() const;
+
+private:
+    /**
+     * Memory of the buffer, it is larger than the saved data.
+     */
+    std::vector<Uint8> m_data;
+    /**
+     * Number of saved bytes.
+     */
+    size_t m_size;
+};
+
+/**
+ * @brief
+ * Reading values from a @a Snapshot in the same order in which they were written.
+ */
+class SnapshotReader
+{
+public:
+    /**
+     * @param snapshot - buffer to read, it has to exist as long as the reader
+     */
+    SnapshotReader(const Snapshot& snapshot);
+    /**
+     * Reading the next value. Reading past the end of the buffer leaves the value unchanged and sets the error flag.
+     * @param value - read value
+     */
+    template<typename T> void read(T& value)
+    {
+        if(m_position + sizeof(T) > m_size)
+        {
+            m_error = true;
+            return;
+        }
+        memcpy(&value, m_data + m_position, sizeof(T));
+        m_position += sizeof(T);
+    }
+    /**
+     * Reading an array of bytes written by @a Snapshot::writeBytes. Reading past the end of the buffer leaves the data unchanged and sets the error flag.
+     * @param data - memory for the read bytes
+     * @param size - number of bytes
+     */
+    void readBytes(void* data, size_t size);
+    /**
+     * @return number of bytes left to read
+     */
+    size_t remaining() const;
+    /**
+     * @return @a true if an attempt was made to read past the end of the buffer
+     */
+    bool error() const;
+
+private:
+    /**
+     * Read bytes.
+     */
+    const Uint8* m_data;
+    /**
+     * Number of bytes in the buffer.
+     */
+    size_t m_size;
+    /**
+     * Position of the next value.
+     */
+    size_t m_position;
+    /**
+     * Variable stores whether reading past the end of the buffer was attempted.
+     */
+    bool m_error;
+};
+
+#endif // SNAPSHOT_H
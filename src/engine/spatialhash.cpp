@@ -0,0 +1,104 @@
+#include "spatialhash.h"
+#include <algorithm>
+
+SpatialHash::SpatialHash(int cell_size)
+{
+    m_cell_size = cell_size;
+    m_mask = 0;
+    m_linear = true;
+}
+
+void SpatialHash::clear()
+{
+    m_items.clear();
+    m_linear = true;
+}
+
+void SpatialHash::insert(const SDL_Rect& rect, int id)
+{
+    if(rect.w <= 0 || rect.h <= 0) return;
+    m_items.push_back({rect, id});
+}
+
+void SpatialHash::build()
+{
+    m_linear = m_items.size() <= linear_limit;
+    if(m_linear) return;
+
+    m_entries.clear();
+    for(auto& item : m_items)
+    {
+        int x_end = cell(item.rect.x + item.rect.w - 1);
+        int y_end = cell(item.rect.y + item.rect.h - 1);
+        for(int y = cell(item.rect.y); y <= y_end; y++)
+            for(int x = cell(item.rect.x); x <= x_end; x++)
+                m_entries.push_back({x, y, item.id});
+    }
+
+    // about two buckets for every entry keeps the buckets short
+    unsigned buckets_count = 16;
+    while(buckets_count < 2 * m_entries.size()) buckets_count *= 2;
+    m_mask = buckets_count - 1;
+
+    // counting sort of the entries by buckets
+    m_offsets.assign(buckets_count + 1, 0);
+    for(auto& entry : m_entries)
+        m_offsets[bucket(entry.cell_x, entry.cell_y) + 1]++;
+    for(unsigned i = 1; i <= buckets_count; i++)
+        m_offsets[i] += m_offsets[i - 1];
+
+    m_ids.resize(m_entries.size());
+    std::vector<unsigned>::iterator next = m_offsets.begin();
+    for(auto& entry : m_entries)
+        m_ids[next[bucket(entry.cell_x, entry.cell_y)]++] = entry.id;
+    // the loop above moved every offset to the start of the next bucket
+    for(unsigned i = buckets_count; i > 0; i--)
+        m_offsets[i] = m_offsets[i - 1];
+    m_offsets[0] = 0;
+}
+
+void SpatialHash::query(const SDL_Rect& rect, std::vector<int>& result) const
+{
+    result.clear();
+    if(rect.w <= 0 || rect.h <= 0) return;
+
+    if(m_linear)
+    {
+        for(auto& item : m_items)
+            if(rect.x < item.rect.x + item.rect.w && item.rect.x < rect.x + rect.w &&
+               rect.y < item.rect.y + item.rect.h && item.rect.y < rect.y + rect.h)
+                result.push_back(item.id);
+    }
+    else
+    {
+        int x_end = cell(rect.x + rect.w - 1);
+        int y_end = cell(rect.y + rect.h - 1);
+        for(int y = cell(rect.y); y <= y_end; y++)
+            for(int x = cell(rect.x); x <= x_end; x++)
+            {
+                unsigned b = bucket(x, y);
+                result.insert(result.end(), m_ids.begin() + m_offsets[b], m_ids.begin() + m_offsets[b + 1]);
+            }
+    }
+
+    if(result.size() > 1)
+    {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+}
+
+unsigned SpatialHash::size() const
+{
+    return m_items.size();
+}
+
+int SpatialHash::cell(int coordinate) const
+{
+    return coordinate >= 0 ? coordinate / m_cell_size : (coordinate - m_cell_size + 1) / m_cell_size;
+}
+
+unsigned SpatialHash::bucket(int cell_x, int cell_y) const
+{
+    return ((unsigned)cell_x * 73856093u ^ (unsigned)cell_y * 19349663u) & m_mask;
+}
@@ -0,0 +1,113 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+/**
+ * @brief
+ * Broad phase of collision detection: a uniform grid of square cells stored in a hash table.
+ * Every inserted rectangle is assigned to all cells it overlaps, a query returns the identifiers of rectangles
+ * sharing a cell with the searched one. The result may contain rectangles that do not intersect the searched one,
+ * the exact test is left to the caller. The grid does not need to know the size of the map, so objects outside of it are handled too.
+ * The grid is rebuilt from scratch every step; after the first steps it works without allocations.
+ * With only a few rectangles hashing costs more than testing them all, so up to @a linear_limit rectangles the query simply
+ * compares the searched rectangle with every inserted one.
+ */
+class SpatialHash
+{
+public:
+    /**
+     * @param cell_size - side of a cell in pixels, the size of a map tile works well
+     */
+    SpatialHash(int cell_size = 16);
+    /**
+     * Removing all rectangles.
+     */
+    void clear();
+    /**
+     * Adding a rectangle. Rectangles with no area are ignored because they cannot collide with anything.
+     * @param rect - rectangle of the object
+     * @param id - identifier returned by @a query, usually an index in a container of objects
+     */
+    void insert(const SDL_Rect& rect, int id);
+    /**
+     * Sorting the inserted rectangles into cells. It has to be called after the last @a insert and before @a query.
+     */
+    void build();
+    /**
+     * Searching for rectangles that may intersect the given one.
+     * @param rect - searched rectangle
+     * @param result - overwritten with identifiers sorted in ascending order, without duplicates
+     */
+    void query(const SDL_Rect& rect, std::vector<int>& result) const;
+    /**
+     * @return number of inserted rectangles
+     */
+    unsigned size() const;
+
+    /**
+     * Maximum number of rectangles searched without the grid.
+     */
+    static const unsigned linear_limit = 16;
+
+private:
+    /**
+     * Inserted rectangle.
+     */
+    struct Item
+    {
+        SDL_Rect rect;
+        int id;
+    };
+
+    /**
+     * Rectangle assigned to one cell.
+     */
+    struct Entry
+    {
+        int cell_x;
+        int cell_y;
+        int id;
+    };
+
+    /**
+     * Converting a pixel coordinate to a cell coordinate, rounding down also for negative values.
+     */
+    int cell(int coordinate) const;
+    /**
+     * @return index of the hash table bucket holding the cell
+     */
+    unsigned bucket(int cell_x, int cell_y) const;
+
+    /**
+     * Side of a cell in pixels.
+     */
+    int m_cell_size;
+    /**
+     * Number of buckets minus one, the number of buckets is a power of two.
+     */
+    unsigned m_mask;
+    /**
+     * Rectangles added by @a insert.
+     */
+    std::vector<Item> m_items;
+    /**
+     * Variable stores whether the rectangles are searched one by one instead of using the grid.
+     */
+    bool m_linear;
+    /**
+     * Rectangles assigned to cells, built by @a build.
+     */
+    std::vector<Entry> m_entries;
+    /**
+     * Index of the first identifier of every bucket in @a m_ids, the last value is the number of identifiers.
+     */
+    std::vector<unsigned> m_offsets;
+    /**
+     * Identifiers grouped by buckets.
+     */
+    std::vector<int> m_ids;
+};
+
+#endif // SPATIALHASH_H
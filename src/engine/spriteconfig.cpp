@@ -1,55 +1,142 @@
 #include "spriteconfig.h"
+#include <fstream>
+#include <sstream>
+
+/**
+ * Default animations of texture.png in the order of @a SpriteType.
+ * Enemy tanks have four directions for every armour level and four columns of bonus blinking on their left,
+ * players have two frames for every number of stars and bricks have a row for every damage state.
+ */
+static constexpr SpriteData default_sprites[ST_NONE] =
+{
+    {ST_TANK_A, 128, 0, 32, 32, 2, 100, true, -4, 20},
+    {ST_TANK_B, 128, 64, 32, 32, 2, 100, true, -4, 20},
+    {ST_TANK_C, 128, 128, 32, 32, 2, 100, true, -4, 20},
+    {ST_TANK_D, 128, 192, 32, 32, 2, 100, true, -4, 20},
+
+    {ST_PLAYER_1, 640, 0, 32, 32, 2, 50, true, 0, 4, 8},
+    {ST_PLAYER_2, 768, 0, 32, 32, 2, 50, true, 0, 4, 8},
+
+    {ST_BRICK_WALL, 928, 0, 16, 16, 1, 200, false, 0, 1, 9},
+    {ST_STONE_WALL, 928, 144, 16, 16, 1, 200, false},
+    {ST_WATER, 928, 160, 16, 16, 2, 350, true},
+    {ST_BUSH, 928, 192, 16, 16, 1, 200, false},
+    {ST_ICE, 928, 208, 16, 16, 1, 200, false},
+
+    {ST_BONUS_GRENADE, 896, 0, 32, 32, 1, 200, false},
+    {ST_BONUS_HELMET, 896, 32, 32, 32, 1, 200, false},
+    {ST_BONUS_CLOCK, 896, 64, 32, 32, 1, 200, false},
+    {ST_BONUS_SHOVEL, 896, 96, 32, 32, 1, 200, false},
+    {ST_BONUS_TANK, 896, 128, 32, 32, 1, 200, false},
+    {ST_BONUS_STAR, 896, 160, 32, 32, 1, 200, false},
+    {ST_BONUS_GUN, 896, 192, 32, 32, 1, 200, false},
+    {ST_BONUS_BOAT, 896, 224, 32, 32, 1, 200, false},
+
+    {ST_SHIELD, 976, 0, 32, 32, 2, 45, true},
+    {ST_CREATE, 1008, 0, 32, 32, 10, 100, false},
+    {ST_DESTROY_TANK, 1040, 0, 64, 64, 7, 70, false},
+    {ST_DESTROY_BULLET, 1108, 0, 32, 32, 5, 40, false},
+    {ST_BOAT_P1, 944, 96, 32, 32, 1, 200, false},
+    {ST_BOAT_P2, 976, 96, 32, 32, 1, 200, false},
+
+    {ST_EAGLE, 944, 0, 32, 32, 1, 200, false},
+    {ST_DESTROY_EAGLE, 1040, 0, 64, 64, 7, 100, false},
+    {ST_FLAG, 944, 32, 32, 32, 1, 200, false},
+
+    {ST_BULLET, 944, 128, 8, 8, 1, 200, false, 0, 4},
+
+    {ST_LEFT_ENEMY, 944, 144, 16, 16, 1, 200, false},
+    {ST_STAGE_STATUS, 976, 64, 32, 32, 1, 200, false},
+
+    {ST_TANKS_LOGO, 0, 260, 406, 72, 1, 200, false}
+};
+
+/**
+ * @return @a true if every entry of @a default_sprites from @a index on is stored at the index of its type
+ */
+static constexpr bool defaultSpritesInOrder(int index = 0)
+{
+    return index >= ST_NONE || (default_sprites[index].type == index && defaultSpritesInOrder(index + 1));
+}
+static_assert(defaultSpritesInOrder(), "default_sprites has to be in the order of SpriteType");
+
+/**
+ * Names of sprite types used in sprite sheet descriptions.
+ */
+static const char* sprite_names[ST_NONE] =
+{
+    "ST_TANK_A", "ST_TANK_B", "ST_TANK_C", "ST_TANK_D",
+    "ST_PLAYER_1", "ST_PLAYER_2",
+    "ST_BRICK_WALL", "ST_STONE_WALL", "ST_WATER", "ST_BUSH", "ST_ICE",
+    "ST_BONUS_GRENADE", "ST_BONUS_HELMET", "ST_BONUS_CLOCK", "ST_BONUS_SHOVEL",
+    "ST_BONUS_TANK", "ST_BONUS_STAR", "ST_BONUS_GUN", "ST_BONUS_BOAT",
+    "ST_SHIELD", "ST_CREATE", "ST_DESTROY_TANK", "ST_DESTROY_BULLET", "ST_BOAT_P1", "ST_BOAT_P2",
+    "ST_EAGLE", "ST_DESTROY_EAGLE", "ST_FLAG",
+    "ST_BULLET",
+    "ST_LEFT_ENEMY", "ST_STAGE_STATUS",
+    "ST_TANKS_LOGO"
+};
 
 SpriteConfig::SpriteConfig()
 {
-    insert(ST_TANK_A, 128, 0, 32, 32, 2, 100, true);
-    insert(ST_TANK_B, 128, 64, 32, 32, 2, 100, true);
-    insert(ST_TANK_C, 128, 128, 32, 32, 2, 100, true);
-    insert(ST_TANK_D, 128, 192, 32, 32, 2, 100, true);
-
-    insert(ST_PLAYER_1, 640, 0, 32, 32, 2, 50, true);
-    insert(ST_PLAYER_2, 768, 0, 32, 32, 2, 50, true);
-
-    insert(ST_BRICK_WALL, 928, 0, 16, 16, 1, 200, false);
-    insert(ST_STONE_WALL, 928, 144, 16, 16, 1, 200, false);
-    insert(ST_WATER, 928, 160, 16, 16, 2, 350, true);
-    insert(ST_BUSH, 928, 192, 16, 16, 1, 200, false);
-    insert(ST_ICE, 928, 208, 16, 16, 1, 200, false);
-
-    insert(ST_BONUS_GRENADE, 896, 0, 32, 32, 1, 200, false);
-    insert(ST_BONUS_HELMET, 896, 32, 32, 32, 1, 200, false);
-    insert(ST_BONUS_CLOCK, 896, 64, 32, 32, 1, 200, false);
-    insert(ST_BONUS_SHOVEL, 896, 96, 32, 32, 1, 200, false);
-    insert(ST_BONUS_TANK, 896, 128, 32, 32, 1, 200, false);
-    insert(ST_BONUS_STAR, 896, 160, 32, 32, 1, 200, false);
-    insert(ST_BONUS_GUN, 896, 192, 32, 32, 1, 200, false);
-    insert(ST_BONUS_BOAT, 896, 224, 32, 32, 1, 200, false);
-
-    insert(ST_SHIELD, 976, 0, 32, 32, 2, 45, true);
-    insert(ST_CREATE, 1008, 0, 32, 32, 10, 100, false);
-    insert(ST_DESTROY_TANK, 1040, 0, 64, 64, 7, 70, false);
-    insert(ST_DESTROY_BULLET, 1108, 0, 32, 32, 5, 40, false);
-    insert(ST_BOAT_P1, 944, 96, 32, 32, 1, 200, false);
-    insert(ST_BOAT_P2, 976, 96, 32, 32, 1, 200, false);
-
-    insert(ST_EAGLE, 944, 0, 32, 32, 1, 200, false);
-    insert(ST_DESTROY_EAGLE, 1040, 0, 64, 64, 7, 100, false);
-    insert(ST_FLAG, 944, 32, 32, 32, 1, 200, false);
-
-    insert(ST_BULLET, 944, 128, 8, 8, 1, 200, false);
-
-    insert(ST_LEFT_ENEMY, 944, 144, 16, 16, 1, 200, false);
-    insert(ST_STAGE_STATUS, 976, 64, 32, 32, 1, 200, false);
-
-    insert(ST_TANKS_LOGO, 0, 260, 406, 72, 1, 200, false);
+    for(int i = 0; i < ST_NONE; i++) m_sprites[i] = default_sprites[i];
+    buildFrames();
 }
 
-const SpriteData* SpriteConfig::getSpriteData(SpriteType st) const
+bool SpriteConfig::load(const std::string& path)
 {
-    return &m_configs.at(st);
+    std::ifstream file(path);
+    if(!file.is_open()) return false;
+
+    SpriteData sprites[ST_NONE];
+    for(int i = 0; i < ST_NONE; i++) sprites[i] = m_sprites[i];
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        if(!(fields >> name) || name[0] == '#') continue;
+
+        int type = 0;
+        while(type < ST_NONE && name != sprite_names[type]) type++;
+        if(type == ST_NONE) return false;
+
+        int x, y, w, h, frames_count, loop;
+        unsigned frame_duration;
+        if(!(fields >> x >> y >> w >> h >> frames_count >> frame_duration >> loop)) return false;
+        int first_column = 0, columns_count = 1, rows_count = 0;
+        if(fields >> first_column && !(fields >> columns_count >> rows_count)) return false;
+        if(w <= 0 || h <= 0 || frames_count <= 0 || columns_count <= 0 || rows_count < 0) return false;
+
+        sprites[type] = SpriteData(static_cast<SpriteType>(type), x, y, w, h, frames_count, frame_duration, loop != 0, first_column, columns_count, rows_count);
+    }
+
+    for(int i = 0; i < ST_NONE; i++) m_sprites[i] = sprites[i];
+    buildFrames();
+    return true;
 }
 
-void SpriteConfig::insert(SpriteType st, int x, int y, int w, int h, int fc, int fd, bool l)
+void SpriteConfig::buildFrames()
 {
-    m_configs[st] = SpriteData(x, y, w, h, fc, fd, l);
+    unsigned cells_count = 0;
+    for(const auto& sprite : m_sprites) cells_count += sprite.columns_count * sprite.rows_count;
+    m_frames.resize(cells_count);
+
+    // the vector is resized before the pointers are taken, so they stay valid until the next call
+    unsigned first = 0;
+    for(auto& sprite : m_sprites)
+    {
+        for(int row = 0; row < sprite.rows_count; row++)
+            for(int column = 0; column < sprite.columns_count; column++)
+            {
+                SDL_Rect& cell = m_frames[first + row * sprite.columns_count + column];
+                cell.x = sprite.rect.x + (sprite.first_column + column) * sprite.rect.w;
+                cell.y = sprite.rect.y + row * sprite.rect.h;
+                cell.w = sprite.rect.w;
+                cell.h = sprite.rect.h;
+            }
+        sprite.frames = m_frames.data() + first;
+        first += sprite.columns_count * sprite.rows_count;
+    }
 }
@@ -2,18 +2,52 @@
 #define SPRITECONFIG_H
 
 #include "../type.h"
-#include <map>
+#include <string>
+#include <vector>
 #include <SDL2/SDL.h>
 
 /**
  * @brief
  * Structure storing information about a given type of object animation.
+ * The texture of an animation is a grid of frames: rows are the frames of the animation and columns are variants,
+ * e.g. directions of a tank or its armour levels. Source rectangles of all cells are calculated once by @a SpriteConfig.
  */
 struct SpriteData
 {
-    SpriteData() { rect.x = 0; rect.y = 0; rect.w = 0; rect.h = 0; frames_count = 0; frame_duration = 0; loop = false;}
-    SpriteData(int x, int y, int w, int h, int fc, int fd, bool l)
-        { rect.x = x; rect.y = y; rect.w = w; rect.h = h; frames_count = fc; frame_duration = fd; loop = l;}
+    constexpr SpriteData()
+        : rect{0, 0, 0, 0}, frames_count(0), frame_duration(0), loop(false), type(ST_NONE),
+          first_column(0), columns_count(0), rows_count(0), frames(nullptr) {}
+    /**
+     * @param t - type of the animation
+     * @param x - horizontal position of the first frame of animation in the texture
+     * @param y - vertical position of the first frame of animation in the texture
+     * @param w - width of the animation frames
+     * @param h - height of the animation frames
+     * @param fc - number of frames in the animation
+     * @param fd - time of displaying one frame
+     * @param l - looping of the animation
+     * @param fcol - column of the leftmost variant relative to the first frame, may be negative
+     * @param cols - number of variant columns
+     * @param rows - number of frame rows, 0 means the number of frames
+     */
+    constexpr SpriteData(SpriteType t, int x, int y, int w, int h, int fc, unsigned fd, bool l, int fcol = 0, int cols = 1, int rows = 0)
+        : rect{x, y, w, h}, frames_count(fc), frame_duration(fd), loop(l), type(t),
+          first_column(fcol), columns_count(cols), rows_count(rows > 0 ? rows : fc), frames(nullptr) {}
+
+    /**
+     * @param column - variant column relative to the first frame
+     * @param row - frame row
+     * @return source rectangle of the cell; indexes outside the grid are moved to its nearest border
+     */
+    const SDL_Rect& frameRect(int column, int row) const
+    {
+        column -= first_column;
+        if(column < 0) column = 0;
+        else if(column >= columns_count) column = columns_count - 1;
+        if(row < 0) row = 0;
+        else if(row >= rows_count) row = rows_count - 1;
+        return frames[row * columns_count + column];
+    }
 
     /**
      * Position and dimensions of the first animation frame
@@ -31,42 +65,74 @@ struct SpriteData
      * Variable determining whether the animation is looped.
      */
     bool loop;
+    /**
+     * Type of the animation, allows to store a reference to the animation without a pointer.
+     */
+    SpriteType type;
+    /**
+     * Column of the leftmost variant relative to the column of the first frame.
+     */
+    int first_column;
+    /**
+     * Number of variant columns.
+     */
+    int columns_count;
+    /**
+     * Number of frame rows, it can be larger than the number of frames if the rows are used for other states, e.g. damage of a wall.
+     */
+    int rows_count;
+    /**
+     * Source rectangles of all cells, row after row; set by @a SpriteConfig.
+     */
+    const SDL_Rect* frames;
 };
 
 /**
  * @brief
  * Class stores information about all types of animations in the game.
+ * The default animations are a constant table indexed by @a SpriteType, so finding an animation is an array access.
  */
 class SpriteConfig
 {
 public:
     /**
-     * The constructor performs the addition of subsequent animations using the @a SpriteConfig::insert function.
+     * The constructor copies the default animations and calculates the source rectangles of their frames.
      */
     SpriteConfig();
     /**
      * Retrieving a selected type of animation.
      * @param sp - the searched type of animation
-     * @return animation of the given type
+     * @return animation of the given type, @a nullptr for @a ST_NONE
      */
-    const SpriteData* getSpriteData(SpriteType sp) const;
+    const SpriteData* getSpriteData(SpriteType sp) const
+    {
+        return static_cast<unsigned>(sp) < ST_NONE ? &m_sprites[sp] : nullptr;
+    }
+    /**
+     * Reading a description of a different sprite sheet. Every line describes one animation:
+     * the name of its type, e.g. ST_TANK_A, x, y, width and height of the first frame, number of frames, frame time in milliseconds,
+     * looping (0 or 1) and optionally the first variant column, the number of columns and the number of rows.
+     * Empty lines and lines starting with # are skipped. Animations missing in the file keep their values.
+     * Objects keep pointers to animations, so the description should be loaded before a game is created.
+     * @param path - path to the description file
+     * @return @a false if the file cannot be read or a line is invalid, the configuration is not changed then
+     */
+    bool load(const std::string& path);
+
 private:
     /**
-     * Container storing all types of animations.
+     * Calculating the source rectangles of all cells of all animations into @a m_frames.
      */
-    std::map<SpriteType, SpriteData> m_configs;
+    void buildFrames();
+
     /**
-     * Function used when adding a new type of animation.
-     * @param st - type of animation
-     * @param x - horizontal position of the first frame of animation in the texture
-     * @param y - vertical position of the first frame of animation in the texture
-     * @param w - width of the animation frames
-     * @param h - height of the animation frames
-     * @param fc - number of frames in the animation
-     * @param fd - time of displaying one frame
-     * @param l - looping of the animation
+     * Animations indexed by their type.
+     */
+    SpriteData m_sprites[ST_NONE];
+    /**
+     * Source rectangles of all animations, pointed to by @a SpriteData::frames.
      */
-    void insert(SpriteType st , int x, int y, int w, int h, int fc, int fd, bool l);
+    std::vector<SDL_Rect> m_frames;
 };
 
 #endif // SPRITECONFIG_H
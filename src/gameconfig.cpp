@@ -0,0 +1,148 @@
+#include "gameconfig.h"
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+/**
+ * Reading exactly one value of a setting.
+ * @param fields - rest of the line after the name
+ * @param value - changed only if the line holds one valid value
+ * @return @a false if the value is missing, invalid or followed by more text
+ */
+template <typename T>
+static bool readValue(std::istringstream& fields, T& value)
+{
+    T read_value;
+    std::string rest;
+    // a stream reads -1 into an unsigned number as its largest value, so a sign is rejected before
+    if(std::is_unsigned<T>::value && (fields >> std::ws).peek() == '-') return false;
+    if(!(fields >> read_value) || fields >> rest) return false;
+    value = read_value;
+    return true;
+}
+
+/**
+ * Reading a number of objects, which has to be at least 1.
+ * @param fields - rest of the line after the name
+ * @param value - changed only if the line holds one valid value
+ * @return @a false if the value is missing, invalid, lower than 1 or followed by more text
+ */
+template <typename T>
+static bool readCount(std::istringstream& fields, T& value)
+{
+    T count = value;
+    if(!readValue(fields, count) || count < 1) return false;
+    value = count;
+    return true;
+}
+
+/**
+ * Reading a list of points given as pairs of numbers.
+ * @param fields - rest of the line after the name
+ * @param points - changed only if the line holds at least @a min_count points and nothing else
+ * @param min_count - number of points needed by the game
+ * @return @a false if the list is invalid or too short
+ */
+static bool readPoints(std::istringstream& fields, std::vector<SDL_Point>& points, unsigned min_count)
+{
+    std::vector<SDL_Point> read_points;
+    SDL_Point point;
+    while(fields >> point.x)
+    {
+        if(!(fields >> point.y)) return false;
+        read_points.push_back(point);
+    }
+    if(!fields.eof() || read_points.size() < min_count) return false;
+    points = read_points;
+    return true;
+}
+
+GameConfig::GameConfig()
+{
+    player_starting_point.push_back({128, 384});
+    player_starting_point.push_back({256, 384});
+    enemy_starting_point.push_back({1, 1});
+    enemy_starting_point.push_back({192, 1});
+    enemy_starting_point.push_back({384, 1});
+    level_start_time = 2000;
+    slip_time = 380;
+    enemy_start_count = 20;
+    enemy_redy_time = 500;
+    player_bullet_max_size = 2;
+    bonus_show_time = 10000;
+    tank_shield_time = 10000;
+    tank_frozen_time = 8000;
+    level_end_time = 5000;
+    protect_eagle_time = 15000;
+    bonus_blink_time = 350;
+    player_reload_time = 120;
+    enemy_max_count_on_map = 4;
+    game_over_entry_speed = 0.13;
+    tank_default_speed = 0.08;
+    bullet_default_speed = 0.23;
+    show_enemy_target = false;
+    show_draw_stats = false;
+}
+
+const GameConfigPtr& GameConfig::defaults()
+{
+    // created on the first call, which is safe on many threads
+    static const GameConfigPtr config = std::make_shared<const GameConfig>();
+    return config;
+}
+
+bool GameConfig::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file.is_open()) return false;
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        if(!(fields >> name) || name[0] == '#') continue;
+        if(!set(line)) return false;
+    }
+    return true;
+}
+
+bool GameConfig::set(const std::string& setting)
+{
+    std::string line = setting;
+    std::string::size_type equals = line.find('=');
+    if(equals != std::string::npos) line[equals] = ' ';
+
+    std::istringstream fields(line);
+    std::string name;
+    if(!(fields >> name)) return false;
+
+    if(name == "player_starting_point") return readPoints(fields, player_starting_point, 2);
+    if(name == "enemy_starting_point") return readPoints(fields, enemy_starting_point, 1);
+    if(name == "level_start_time") return readValue(fields, level_start_time);
+    if(name == "slip_time") return readValue(fields, slip_time);
+    if(name == "enemy_start_count") return readCount(fields, enemy_start_count);
+    if(name == "enemy_redy_time") return readValue(fields, enemy_redy_time);
+    if(name == "player_bullet_max_size") return readCount(fields, player_bullet_max_size);
+    if(name == "bonus_show_time") return readValue(fields, bonus_show_time);
+    if(name == "tank_shield_time") return readValue(fields, tank_shield_time);
+    if(name == "tank_frozen_time") return readValue(fields, tank_frozen_time);
+    if(name == "level_end_time") return readValue(fields, level_end_time);
+    if(name == "protect_eagle_time") return readValue(fields, protect_eagle_time);
+    if(name == "bonus_blink_time")
+    {
+        // the bonus blinks twice as fast before it disappears, so half of the time cannot be 0
+        unsigned time = bonus_blink_time;
+        if(!readValue(fields, time) || time < 2) return false;
+        bonus_blink_time = time;
+        return true;
+    }
+    if(name == "player_reload_time") return readValue(fields, player_reload_time);
+    if(name == "enemy_max_count_on_map") return readCount(fields, enemy_max_count_on_map);
+    if(name == "game_over_entry_speed") return readValue(fields, game_over_entry_speed);
+    if(name == "tank_default_speed") return readValue(fields, tank_default_speed);
+    if(name == "bullet_default_speed") return readValue(fields, bullet_default_speed);
+    if(name == "show_enemy_target") return readValue(fields, show_enemy_target);
+    if(name == "show_draw_stats") return readValue(fields, show_draw_stats);
+    return false;
+}
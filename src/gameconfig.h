@@ -0,0 +1,134 @@
+#ifndef GAMECONFIG_H
+#define GAMECONFIG_H
+
+#include <SDL2/SDL_rect.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GameConfig;
+
+/**
+ * Configuration shared by a game, the following levels and their objects. It is not changed after it is shared.
+ */
+typedef std::shared_ptr<const GameConfig> GameConfigPtr;
+
+/**
+ * @brief
+ * Rules of one game: speeds, timers, numbers of enemies and starting positions.
+ * Every game gets its own configuration and passes it to its tanks and bonuses, so games with different rules
+ * can be played at the same time, also on different threads. A configuration is filled before the game starts,
+ * from a file with @a load or from the command line with @a set, and is only read afterwards.
+ *
+ * Every line of a file is one setting: the name followed by the value, e.g. <em>enemy_max_count_on_map 8</em>.
+ * Points are given as pairs of numbers, e.g. <em>player_starting_point 128 384 256 384</em>. Lines starting with # are skipped.
+ */
+class GameConfig
+{
+public:
+    /**
+     * Creating the configuration of the original game.
+     */
+    GameConfig();
+
+    /**
+     * @return configuration of the original game, used when no other configuration is given
+     */
+    static const GameConfigPtr& defaults();
+    /**
+     * Reading settings from a file. Settings missing in the file keep their values.
+     * @param path - path to the file
+     * @return @a false if the file cannot be read or a line is not a valid setting, the settings before that line are set
+     */
+    bool load(const std::string& path);
+    /**
+     * Changing one setting.
+     * @param setting - name and value separated by spaces or by =, e.g. <em>tank_default_speed=0.1</em>
+     * Numbers of enemies and bullets have to be at least 1 and values of unsigned settings, e.g. times, cannot be negative.
+     * @return @a false for an unknown name or an invalid value, the setting is not changed then
+     */
+    bool set(const std::string& setting);
+
+    /**
+     * two starting positions of players.
+     */
+    std::vector<SDL_Point> player_starting_point;
+    /**
+     * starting positions of enemies, used in turn.
+     */
+    std::vector<SDL_Point> enemy_starting_point;
+    /**
+     * time displayed and number of the round at its start.
+     */
+    unsigned level_start_time;
+    /**
+     * duration of slip on ice in milliseconds.
+     */
+    unsigned slip_time;
+    /**
+     * number of enemies to kill in one round.
+     */
+    unsigned enemy_start_count;
+    /**
+     * the time after which a new enemy may appear on the map in milliseconds.
+     */
+    unsigned enemy_redy_time;
+    /**
+     * default maximum number of shells a player can fire.
+     */
+    unsigned player_bullet_max_size;
+    /**
+     * the length of time the bonus is visible on the map in milliseconds.
+     */
+    unsigned bonus_show_time;
+    /**
+     * casing operating time in milliseconds.
+     */
+    unsigned tank_shield_time;
+    /**
+     * the length of time enemies are frozen in milliseconds.
+     */
+    unsigned tank_frozen_time;
+    /**
+     * Time between killing all enemies and going to the result window in milliseconds.
+     */
+    unsigned level_end_time;
+    /**
+     * duration of the stone casing around the eagle in milliseconds.
+     */
+    unsigned protect_eagle_time;
+    /**
+     * bonus flashing time in milliseconds.
+     */
+    unsigned bonus_blink_time;
+    /**
+     * Minimum time between the player firing projectiles in milliseconds.
+     */
+    unsigned player_reload_time;
+    /**
+     * maximum number of tanks on the map in one moment.
+     */
+    int enemy_max_count_on_map;
+    /**
+     * speed of movement napsu game over.
+     */
+    double game_over_entry_speed;
+    /**
+     * nominal tank speed.
+     */
+    double tank_default_speed;
+    /**
+     * nominal projectile velocity.
+     */
+    double bullet_default_speed;
+    /**
+     * Whether the paths to targets of enemies are shown when a level starts; switched in the game with T.
+     */
+    bool show_enemy_target;
+    /**
+     * Whether the numbers of draw calls and sprites are shown in the status panel when a level starts; switched in the game with I.
+     */
+    bool show_draw_stats;
+};
+
+#endif // GAMECONFIG_H
@@ -10,10 +10,40 @@
 */
 
 #include "app.h"
+#include "appconfig.h"
+#include "gameconfig.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 int main( int argc, char* args[] )
 {
     App app;
+    GameConfig config;
+    for(int i = 1; i + 1 < argc; i++)
+    {
+        if(!strcmp(args[i], "--record")) app.setRecordPath(args[++i]);
+        else if(!strcmp(args[i], "--replay")) app.setReplayPath(args[++i]);
+        else if(!strcmp(args[i], "--sprites")) AppConfig::sprites_path = args[++i];
+        else if(!strcmp(args[i], "--speed")) app.setTimeScale(strcmp(args[++i], "max") ? atoi(args[i]) : 0);
+        else if(!strcmp(args[i], "--config"))
+        {
+            if(!config.load(args[++i]))
+            {
+                std::cerr << "Cannot load game configuration " << args[i] << std::endl;
+                return 1;
+            }
+        }
+        else if(!strcmp(args[i], "--set"))
+        {
+            if(!config.set(args[++i]))
+            {
+                std::cerr << "Invalid setting " << args[i] << std::endl;
+                return 1;
+            }
+        }
+    }
+    app.setGameConfig(std::make_shared<const GameConfig>(config));
     app.run();
 
     return 0;
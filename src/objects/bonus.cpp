@@ -1,16 +1,17 @@
 #include "bonus.h"
-#include "../appconfig.h"
 
-Bonus::Bonus()
-    : Object(0, 0, ST_BONUS_STAR)
+Bonus::Bonus(Engine* engine, const GameConfig* config)
+    : Object(engine, 0, 0, ST_BONUS_STAR)
 {
+    m_config = config;
     m_bonus_show_time = 0;
     m_show = true;
 }
 
-Bonus::Bonus(double x, double y, SpriteType type)
-    : Object(x, y, type)
+Bonus::Bonus(Engine* engine, double x, double y, SpriteType type, const GameConfig* config)
+    : Object(engine, x, y, type)
 {
+    m_config = config;
     m_bonus_show_time = 0;
     m_show = true;
 }
@@ -24,10 +25,24 @@ void Bonus::update(Uint32 dt)
 {
     Object::update(dt);
     m_bonus_show_time += dt;
-    if(m_bonus_show_time > AppConfig::bonus_show_time)
+    if(m_bonus_show_time > m_config->bonus_show_time)
         to_erase = true;
 
-    if(m_bonus_show_time / (m_bonus_show_time < AppConfig::bonus_show_time / 4 * 3 ? AppConfig::bonus_blink_time : AppConfig::bonus_blink_time / 2) % 2)
+    if(m_bonus_show_time / (m_bonus_show_time < m_config->bonus_show_time / 4 * 3 ? m_config->bonus_blink_time : m_config->bonus_blink_time / 2) % 2)
         m_show = true;
     else m_show = false;
 }
+
+void Bonus::saveState(Snapshot& snapshot) const
+{
+    Object::saveState(snapshot);
+    snapshot.write(m_bonus_show_time);
+    snapshot.write(m_show);
+}
+
+void Bonus::loadState(SnapshotReader& reader)
+{
+    Object::loadState(reader);
+    reader.read(m_bonus_show_time);
+    reader.read(m_show);
+}
@@ -2,6 +2,7 @@
 #define BONUS_H
 
 #include "object.h"
+#include "../gameconfig.h"
 
 /**
  * @brief Class responsible for displaying the bonus.
@@ -11,15 +12,19 @@ class Bonus : public Object
 public:
     /**
      * Creating a default bonus - a star at position (0, 0).
+     * @param engine - context of the game the bonus belongs to
+     * @param config - rules of the game the bonus belongs to
      */
-    Bonus();
+    Bonus(Engine* engine, const GameConfig* config);
     /**
      * Creating a bonus.
+     * @param engine - context of the game the bonus belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param type - type of bonus
+     * @param config - rules of the game the bonus belongs to
      */
-    Bonus(double x, double y, SpriteType type);
+    Bonus(Engine* engine, double x, double y, SpriteType type, const GameConfig* config);
 
     /**
      * Function for drawing the bonus.
@@ -31,7 +36,21 @@ public:
      * @param dt - time since the last function call
      */
     void update(Uint32 dt);
+    /**
+     * Appending the state of the bonus including the time since it appeared.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState.
+     * @param reader - buffer of the saved game
+     */
+    void loadState(SnapshotReader& reader);
 private:
+    /**
+     * Rules of the game the bonus belongs to: the time it is shown and the blinking.
+     */
+    const GameConfig* m_config;
     /**
      * Time since the bonus was created.
      */
@@ -1,28 +1,34 @@
 #include "bullet.h"
 #include "../appconfig.h"
 
-Bullet::Bullet()
-    : Object(0, 0, ST_BULLET)
+Bullet::Bullet(Engine* engine)
+    : Object(engine, 0, 0, ST_BULLET)
 {
     speed = 0.0;
     direction = D_UP;
     increased_damage = false;
     collide = false;
+    previous_x = pos_x;
+    previous_y = pos_y;
 }
 
-Bullet::Bullet(double x, double y)
-    : Object(x, y, ST_BULLET)
+Bullet::Bullet(Engine* engine, double x, double y)
+    : Object(engine, x, y, ST_BULLET)
 {
     speed = 0.0;
     direction = D_UP;
     increased_damage = false;
     collide = false;
+    previous_x = pos_x;
+    previous_y = pos_y;
 }
 
 void Bullet::update(Uint32 dt)
 {
     if(!collide)
     {
+        previous_x = pos_x;
+        previous_y = pos_y;
         switch (direction)
         {
         case D_UP:
@@ -39,7 +45,7 @@ void Bullet::update(Uint32 dt)
             break;
         }
 
-        src_rect = moveRect(m_sprite->rect, direction, 0);
+        src_rect = m_sprite->frameRect(direction, 0);
         Object::update(dt);
     }
     else
@@ -54,12 +60,34 @@ void Bullet::update(Uint32 dt)
                 if(m_current_frame >= m_sprite->frames_count)
                     to_erase = true;
 
-                src_rect = moveRect(m_sprite->rect, 0, m_current_frame);
+                src_rect = m_sprite->frameRect(0, m_current_frame);
             }
         }
     }
 }
 
+void Bullet::saveState(Snapshot& snapshot) const
+{
+    Object::saveState(snapshot);
+    snapshot.write(speed);
+    snapshot.write(collide);
+    snapshot.write(increased_damage);
+    snapshot.write(direction);
+    snapshot.write(previous_x);
+    snapshot.write(previous_y);
+}
+
+void Bullet::loadState(SnapshotReader& reader)
+{
+    Object::loadState(reader);
+    reader.read(speed);
+    reader.read(collide);
+    reader.read(increased_damage);
+    reader.read(direction);
+    reader.read(previous_x);
+    reader.read(previous_y);
+}
+
 void Bullet::destroy()
 {
     if(collide) return; // prevents multiple invocations
@@ -68,7 +96,7 @@ void Bullet::destroy()
     speed = 0;
     m_current_frame = 0;
     m_frame_display_time = 0;
-    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_DESTROY_BULLET);
+    m_sprite = m_engine->getSpriteConfig()->getSpriteData(ST_DESTROY_BULLET);
 
     switch(direction)
     {
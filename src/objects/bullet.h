@@ -11,14 +11,16 @@ class Bullet : public Object
 public:
     /**
      * Creating a bullet at position (0, 0).
+     * @param engine - context of the game the bullet belongs to
      */
-    Bullet();
+    Bullet(Engine* engine);
     /**
      * Creating a bullet
+     * @param engine - context of the game the bullet belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      */
-    Bullet(double x, double y);
+    Bullet(Engine* engine, double x, double y);
 
     /**
      * Updating the bullet's position.
@@ -29,6 +31,16 @@ public:
      * Activating the bullet's explosion animation.
      */
     void destroy();
+    /**
+     * Appending the state of the bullet: speed, direction, damage and explosion.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState.
+     * @param reader - buffer of the saved game
+     */
+    void loadState(SnapshotReader& reader);
     
     /**
      * The speed of the bullet's movement.
@@ -47,6 +59,14 @@ public:
      * The direction of the bullet's movement.
      */
     Direction direction;
+    /**
+     * Horizontal position before the last step, the bullet travelled from it to @a pos_x.
+     */
+    double previous_x;
+    /**
+     * Vertical position before the last step, the bullet travelled from it to @a pos_y.
+     */
+    double previous_y;
 };
 
 #endif // BULLET_H
@@ -0,0 +1,60 @@
+#include "bulletpool.h"
+
+BulletPool::BulletPool(Engine* engine, unsigned capacity)
+    : m_bullets(capacity, Bullet(engine))
+{
+    m_engine = engine;
+    m_free.reserve(capacity);
+    for(unsigned i = capacity; i > 0; i--) m_free.push_back(i - 1);
+    m_peak_count = 0;
+    m_overflow_count = 0;
+}
+
+Bullet* BulletPool::acquire(double x, double y)
+{
+    if(m_free.empty()) return nullptr;
+
+    Bullet* bullet = &m_bullets[m_free.back()];
+    m_free.pop_back();
+    *bullet = Bullet(m_engine, x, y);
+
+    unsigned live_count = getLiveCount();
+    if(live_count > m_peak_count) m_peak_count = live_count;
+    return bullet;
+}
+
+void BulletPool::release(Bullet* bullet)
+{
+    if(!owns(bullet)) return;
+    m_free.push_back(bullet - m_bullets.data());
+}
+
+bool BulletPool::owns(const Bullet* bullet) const
+{
+    return !m_bullets.empty() && bullet >= m_bullets.data() && bullet < m_bullets.data() + m_bullets.size();
+}
+
+unsigned BulletPool::getCapacity() const
+{
+    return m_bullets.size();
+}
+
+unsigned BulletPool::getLiveCount() const
+{
+    return m_bullets.size() - m_free.size();
+}
+
+unsigned BulletPool::getPeakCount() const
+{
+    return m_peak_count;
+}
+
+unsigned BulletPool::getOverflowCount() const
+{
+    return m_overflow_count;
+}
+
+void BulletPool::countOverflow()
+{
+    m_overflow_count++;
+}
@@ -0,0 +1,84 @@
+#ifndef BULLETPOOL_H
+#define BULLETPOOL_H
+
+#include "bullet.h"
+#include <vector>
+
+/**
+ * @brief
+ * Fixed number of bullets allocated once per game and reused by all tanks, so firing does not allocate memory.
+ * Released bullets go to a list of free slots and the next shot takes the most recently released one.
+ * The storage never moves, so pointers to bullets stay valid until they are released.
+ */
+class BulletPool
+{
+public:
+    /**
+     * @param engine - context of the game the bullets belong to
+     * @param capacity - number of bullets that can exist at the same time
+     */
+    BulletPool(Engine* engine, unsigned capacity = 256);
+
+    /**
+     * Taking a free bullet and setting it to the state of a new bullet.
+     * @param x - initial horizontal position
+     * @param y - initial vertical position
+     * @return pointer to the bullet or @a nullptr if all bullets are used
+     */
+    Bullet* acquire(double x, double y);
+    /**
+     * Returning a bullet to the pool.
+     * @param bullet - bullet taken by @a acquire
+     */
+    void release(Bullet* bullet);
+    /**
+     * @param bullet - checked bullet
+     * @return @a true if the bullet is stored in this pool
+     */
+    bool owns(const Bullet* bullet) const;
+
+    /**
+     * @return maximum number of bullets existing at the same time
+     */
+    unsigned getCapacity() const;
+    /**
+     * @return number of bullets currently in use
+     */
+    unsigned getLiveCount() const;
+    /**
+     * @return highest number of bullets in use at the same time since the pool was created
+     */
+    unsigned getPeakCount() const;
+    /**
+     * @return number of bullets that did not fit in the pool and were allocated separately by @a Tank
+     */
+    unsigned getOverflowCount() const;
+    /**
+     * Counting a bullet allocated outside the pool because the pool was full.
+     */
+    void countOverflow();
+
+private:
+    /**
+     * Context of the game the bullets belong to.
+     */
+    Engine* m_engine;
+    /**
+     * Storage of all bullets.
+     */
+    std::vector<Bullet> m_bullets;
+    /**
+     * Indexes of free bullets in @a m_bullets, the last one is taken first.
+     */
+    std::vector<unsigned> m_free;
+    /**
+     * Highest number of bullets in use.
+     */
+    unsigned m_peak_count;
+    /**
+     * Number of bullets allocated outside the pool.
+     */
+    unsigned m_overflow_count;
+};
+
+#endif // BULLETPOOL_H
@@ -1,12 +1,12 @@
 #include "eagle.h"
 
-Eagle::Eagle()
-    : Object(0, 0, ST_EAGLE)
+Eagle::Eagle(Engine* engine)
+    : Object(engine, 0, 0, ST_EAGLE)
 {
 }
 
-Eagle::Eagle(double x, double y)
-    : Object(x, y, ST_EAGLE)
+Eagle::Eagle(Engine* engine, double x, double y)
+    : Object(engine, x, y, ST_EAGLE)
 {
 }
 
@@ -21,12 +21,12 @@ void Eagle::update(Uint32 dt)
             m_current_frame++;
             if(m_current_frame >= m_sprite->frames_count)
             {
-                m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_FLAG);
+                m_sprite = m_engine->getSpriteConfig()->getSpriteData(ST_FLAG);
                 m_current_frame = 0;
                 type = ST_FLAG;
                 update(0);
             }
-            src_rect = moveRect(m_sprite->rect, 0, m_current_frame);
+            src_rect = m_sprite->frameRect(0, m_current_frame);
         }
     }
     else
@@ -37,9 +37,9 @@ void Eagle::destroy()
 {
     if(type != ST_EAGLE) return;
 
-    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_DESTROY_EAGLE);
+    m_sprite = m_engine->getSpriteConfig()->getSpriteData(ST_DESTROY_EAGLE);
     type = ST_DESTROY_EAGLE;
-    src_rect = moveRect(m_sprite->rect, 0, 0);
+    src_rect = m_sprite->frameRect(0, 0);
 
     dest_rect.x = pos_x + (dest_rect.w - m_sprite->rect.w)/2;
     dest_rect.y = pos_y + (dest_rect.h - m_sprite->rect.h)/2;
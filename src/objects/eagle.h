@@ -11,14 +11,16 @@ class Eagle : public Object
 public:
     /**
      * Creating an eagle at position (0, 0).
+     * @param engine - context of the game the eagle belongs to
      */
-    Eagle();
+    Eagle(Engine* engine);
     /**
      * Creating an eagle
+     * @param engine - context of the game the eagle belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      */
-    Eagle(double x, double y);
+    Eagle(Engine* engine, double x, double y);
     /**
      * Updating the eagle's animation.
      * @param dt - time since the last function call
@@ -1,12 +1,13 @@
 #include "enemy.h"
 #include "../appconfig.h"
 #include <stdlib.h>
-#include <ctime>
+#include <cmath>
 #include <iostream>
 
-Enemy::Enemy()
-    : Tank(AppConfig::enemy_starting_point.at(0).x, AppConfig::enemy_starting_point.at(0).y, ST_TANK_A)
+Enemy::Enemy(Engine* engine, Random *random, const GameConfig* config)
+    : Tank(engine, config->enemy_starting_point.at(0).x, config->enemy_starting_point.at(0).y, ST_TANK_A, config)
 {
+    m_random = random;
     direction = D_DOWN;
     m_direction_time = 0;
     m_keep_direction_time = 100;
@@ -23,18 +24,22 @@ Enemy::Enemy()
     m_frozen_time = 0;
 
     if(type == ST_TANK_B)
-        default_speed = AppConfig::tank_default_speed * 1.3;
+        default_speed = m_config->tank_default_speed * 1.3;
     else
-        default_speed = AppConfig::tank_default_speed;
+        default_speed = m_config->tank_default_speed;
 
     target_position = {-1, -1};
+    target_field = nullptr;
+    target_in_sight = false;
+    m_follow_target = false;
 
     respawn();
 }
 
-Enemy::Enemy(double x, double y, SpriteType type)
-    : Tank(x, y, type)
+Enemy::Enemy(Engine* engine, double x, double y, SpriteType type, Random *random, const GameConfig* config)
+    : Tank(engine, x, y, type, config)
 {
+    m_random = random;
     direction = D_DOWN;
     m_direction_time = 0;
     m_keep_direction_time = 100;
@@ -51,11 +56,14 @@ Enemy::Enemy(double x, double y, SpriteType type)
     m_frozen_time = 0;
 
     if(type == ST_TANK_B)
-        default_speed = AppConfig::tank_default_speed * 1.3;
+        default_speed = m_config->tank_default_speed * 1.3;
     else
-        default_speed = AppConfig::tank_default_speed;
+        default_speed = m_config->tank_default_speed;
 
     target_position = {-1, -1};
+    target_field = nullptr;
+    target_in_sight = false;
+    m_follow_target = false;
 
     respawn();
 }
@@ -63,21 +71,24 @@ Enemy::Enemy(double x, double y, SpriteType type)
 void Enemy::draw()
 {
     if(to_erase) return;
-    if(AppConfig::show_enemy_target)
-    {
-        SDL_Color c;
-        if(type == ST_TANK_A) c = {250, 0, 0, 250};
-        if(type == ST_TANK_B) c = {0, 0, 250, 255};
-        if(type == ST_TANK_C) c = {0, 255, 0, 250};
-        if(type == ST_TANK_D) c = {250, 0, 255, 250};
-        SDL_Rect r = {min(target_position.x, dest_rect.x + dest_rect.w / 2), dest_rect.y + dest_rect.h / 2, abs(target_position.x - (dest_rect.x + dest_rect.w / 2)), 1};
-        Engine::getEngine().getRenderer()->drawRect(&r, c,  true);
-        r = {target_position.x, min(target_position.y, dest_rect.y + dest_rect.h / 2), 1, abs(target_position.y - (dest_rect.y + dest_rect.h / 2))};
-        Engine::getEngine().getRenderer()->drawRect(&r, c, true);
-    }
     Tank::draw();
 }
 
+void Enemy::drawTarget()
+{
+    Renderer* renderer = m_engine->getRenderer();
+    if(to_erase || renderer == nullptr) return;
+    SDL_Color c;
+    if(type == ST_TANK_A) c = {250, 0, 0, 250};
+    if(type == ST_TANK_B) c = {0, 0, 250, 255};
+    if(type == ST_TANK_C) c = {0, 255, 0, 250};
+    if(type == ST_TANK_D) c = {250, 0, 255, 250};
+    SDL_Rect r = {min(target_position.x, dest_rect.x + dest_rect.w / 2), dest_rect.y + dest_rect.h / 2, abs(target_position.x - (dest_rect.x + dest_rect.w / 2)), 1};
+    renderer->drawRect(&r, c,  true);
+    r = {target_position.x, min(target_position.y, dest_rect.y + dest_rect.h / 2), 1, abs(target_position.y - (dest_rect.y + dest_rect.h / 2))};
+    renderer->drawRect(&r, c, true);
+}
+
 void Enemy::update(Uint32 dt)
 {
     if(to_erase) return;
@@ -86,12 +97,12 @@ void Enemy::update(Uint32 dt)
     if(testFlag(TSF_LIFE))
     {
         if(testFlag(TSF_BONUS))
-            src_rect = moveRect(m_sprite->rect, (testFlag(TSF_ON_ICE) ? new_direction : direction) - 4, m_current_frame);
+            src_rect = m_sprite->frameRect((testFlag(TSF_ON_ICE) ? new_direction : direction) - 4, m_current_frame);
         else
-            src_rect = moveRect(m_sprite->rect, (testFlag(TSF_ON_ICE) ? new_direction : direction) + (lives_count -1) * 4, m_current_frame);
+            src_rect = m_sprite->frameRect((testFlag(TSF_ON_ICE) ? new_direction : direction) + (lives_count -1) * 4, m_current_frame);
     }
     else
-        src_rect = moveRect(m_sprite->rect, 0, m_current_frame);
+        src_rect = m_sprite->frameRect(0, m_current_frame);
 
     if(testFlag(TSF_FROZEN)) return;
 
@@ -101,29 +112,33 @@ void Enemy::update(Uint32 dt)
     if(m_direction_time > m_keep_direction_time)
     {
         m_direction_time = 0;
-        m_keep_direction_time = rand() % 800 + 100;
+        m_keep_direction_time = m_random->nextInt(800) + 100;
 
-        float p = static_cast<float>(rand()) / RAND_MAX;
+        float p = m_random->nextFloat();
 
-        if(p < (type == ST_TANK_A ? 0.8 : 0.5) && target_position.x > 0 && target_position.y > 0)
+        m_follow_target = p < (type == ST_TANK_A ? 0.8 : 0.5) && target_position.x > 0 && target_position.y > 0;
+        if(!m_follow_target)
+            setDirection(static_cast<Direction>(m_random->nextInt(4)));
+        else if(!followField())
         {
+            // without a direction from the flow field the enemy heads straight to the target
             int dx = target_position.x - (dest_rect.x + dest_rect.w / 2);
             int dy = target_position.y - (dest_rect.y + dest_rect.h / 2);
 
-            p = static_cast<float>(rand()) / RAND_MAX;
+            p = m_random->nextFloat();
 
             if(abs(dx) > abs(dy))
                 setDirection(p < 0.7 ? (dx < 0 ? D_LEFT : D_RIGHT) : (dy < 0 ? D_UP : D_DOWN));
             else
                 setDirection(p < 0.7 ? (dy < 0 ? D_UP : D_DOWN) : (dx < 0 ? D_LEFT : D_RIGHT));
         }
-        else
-            setDirection(static_cast<Direction>(rand() % 4));
     }
+    else if(m_follow_target)
+        followField();
     if(m_speed_time > m_try_to_go_time)
     {
         m_speed_time = 0;
-        m_try_to_go_time = rand() % 300;
+        m_try_to_go_time = m_random->nextInt(300);
         speed = default_speed;
     }
     if(m_fire_time > m_reload_time)
@@ -131,36 +146,37 @@ void Enemy::update(Uint32 dt)
         m_fire_time = 0;
         if(type == ST_TANK_D)
         {
-            m_reload_time = rand() % 400;
+            m_reload_time = m_random->nextInt(400);
             int dx = target_position.x - (dest_rect.x + dest_rect.w / 2);
             int dy = target_position.y - (dest_rect.y + dest_rect.h / 2);
 
+            // a stopped tank shoots the wall in its way, a moving one only a target that a bullet can reach
             if(stop) fire();
             else
                 switch (direction)
                 {
                 case D_UP:
-                    if(dy < 0 && abs(dx) < dest_rect.w) fire();
+                    if(target_in_sight && dy < 0 && abs(dx) < dest_rect.w) fire();
                     break;
                 case D_RIGHT:
-                    if(dx > 0 && abs(dy) < dest_rect.h) fire();
+                    if(target_in_sight && dx > 0 && abs(dy) < dest_rect.h) fire();
                     break;
                 case D_DOWN:
-                    if(dy > 0 && abs(dx) < dest_rect.w) fire();
+                    if(target_in_sight && dy > 0 && abs(dx) < dest_rect.w) fire();
                     break;
                 case D_LEFT:
-                    if(dx < 0 && abs(dy) < dest_rect.h) fire();
+                    if(target_in_sight && dx < 0 && abs(dy) < dest_rect.h) fire();
                     break;
                 }
         }
         else if(type == ST_TANK_C)
         {
-            m_reload_time = rand() % 800;
+            m_reload_time = m_random->nextInt(800);
             fire();
         }
         else
         {
-            m_reload_time = rand() % 1000;
+            m_reload_time = m_random->nextInt(1000);
             fire();
         }
     }
@@ -168,6 +184,24 @@ void Enemy::update(Uint32 dt)
     stop = false;
 }
 
+bool Enemy::followField()
+{
+    Direction next;
+    if(target_field == nullptr || !target_field->getDirection(pos_x, pos_y, next)) return false;
+    if(next == direction) return true;
+
+    if(next % 2 != direction % 2 && !stop)
+    {
+        // turning to the side waits until the tank is close to the middle of the field, setDirection aligns it then
+        double pos = (direction == D_UP || direction == D_DOWN) ? pos_y : pos_x;
+        int size = (direction == D_UP || direction == D_DOWN) ? AppConfig::tile_rect.h : AppConfig::tile_rect.w;
+        double offset = pos - (int)((pos + size / 2) / size) * size;
+        if(fabs(offset) >= 5) return true;
+    }
+    setDirection(next);
+    return true;
+}
+
 void Enemy::destroy()
 {
     lives_count--;
@@ -175,7 +209,7 @@ void Enemy::destroy()
     if(lives_count <= 0)
     {
         lives_count = 0;
-        Mix_PlayChannel(SND_hit, AppConfig::sounds[SND_hit], 0);
+        if(AppConfig::sounds[SND_hit] != nullptr) Mix_PlayChannel(SND_hit, AppConfig::sounds[SND_hit], 0);
         Tank::destroy();
     }
 }
@@ -185,3 +219,29 @@ unsigned Enemy::scoreForHit()
     if(lives_count > 0) return 50;
     return 100;
 }
+
+void Enemy::saveState(Snapshot& snapshot) const
+{
+    Tank::saveState(snapshot);
+    snapshot.write(target_position);
+    snapshot.write(m_direction_time);
+    snapshot.write(m_keep_direction_time);
+    snapshot.write(m_speed_time);
+    snapshot.write(m_try_to_go_time);
+    snapshot.write(m_fire_time);
+    snapshot.write(m_reload_time);
+    snapshot.write(m_follow_target);
+}
+
+void Enemy::loadState(SnapshotReader& reader)
+{
+    Tank::loadState(reader);
+    reader.read(target_position);
+    reader.read(m_direction_time);
+    reader.read(m_keep_direction_time);
+    reader.read(m_speed_time);
+    reader.read(m_try_to_go_time);
+    reader.read(m_fire_time);
+    reader.read(m_reload_time);
+    reader.read(m_follow_target);
+}
@@ -2,6 +2,8 @@
 #define ENEMY_H
 
 #include "tank.h"
+#include "../engine/random.h"
+#include "flowfield.h"
 
 /**
  * @brief Class responsible for the movements of enemy tanks.
@@ -11,21 +13,31 @@ class Enemy : public Tank
 public:
     /**
      * Creating an enemy at one of the starting positions for enemies.
-     * @see AppConfig::enemy_starting_point
+     * @param engine - context of the game the enemy belongs to
+     * @param random - random number generator of the game, used for all decisions of the enemy
+     * @param config - rules of the game the enemy belongs to
+     * @see GameConfig::enemy_starting_point
      */
-    Enemy();
+    Enemy(Engine* engine, Random* random, const GameConfig* config);
     /**
      * Creating an enemy
+     * @param engine - context of the game the enemy belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param type - type of enemy tank
+     * @param random - random number generator of the game, used for all decisions of the enemy
+     * @param config - rules of the game the enemy belongs to
      */
-    Enemy(double x, double y, SpriteType type);
+    Enemy(Engine* engine, double x, double y, SpriteType type, Random* random, const GameConfig* config);
 
     /**
-     * The function draws the enemy tank and if the flag @a AppConfig::show_enemy_target is set, it draws a line connecting the tank with its target.
+     * The function draws the enemy tank.
      */
     void draw();
+    /**
+     * The function draws a line connecting the tank with its target, shown by the game after pressing T. Nothing is drawn if the context has no renderer.
+     */
+    void drawTarget();
     /**
      * The function updates the position of the tank and decides on the direction and timing of the next shot depending on the type of enemy.
      * @param dt - time since the last function call
@@ -40,13 +52,42 @@ public:
      * @return points
      */
     unsigned scoreForHit();
+    /**
+     * Appending the state of the enemy: the tank, the target and the timers of its decisions.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState.
+     * @param reader - buffer of the saved game
+     */
+    void loadState(SnapshotReader& reader);
 
     /**
      * The position towards which the enemy tank is heading.
      */
     SDL_Point target_position;
+    /**
+     * Flow field of the target set by the game every step, @a nullptr if the target cannot be reached by it.
+     */
+    const FlowField* target_field;
+    /**
+     * Variable set by the game every step for enemies D: the target lies in a straight line from the tank along a row or a column and no wall stops a bullet on the way.
+     */
+    bool target_in_sight;
 
 private:
+    /**
+     * Turning towards the next field on the way to the target given by @a target_field.
+     * The tank turns to the side only when it is close to the middle of a field, so it does not hit the corners of walls.
+     * @return @a false if the field does not give a direction, e.g. at the target
+     */
+    bool followField();
+
+    /**
+     * Random number generator of the game to which the enemy belongs.
+     */
+    Random* m_random;
     /**
      * Time since the last direction change.
      */
@@ -73,6 +114,10 @@ private:
      * Time after which an attempt for the next shot will be made.
      */
     Uint32 m_reload_time;
+    /**
+     * Variable stores whether the enemy follows its target until the next decision, otherwise it drives in a random direction.
+     */
+    bool m_follow_target;
 };
 
 #endif // ENEMY_H
@@ -0,0 +1,273 @@
+#include "flowfield.h"
+#include "../appconfig.h"
+#include <algorithm>
+#include <functional>
+
+/**
+ * Shift of the node to the neighbour in every direction: rows and columns.
+ */
+static const int direction_step[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+
+const Uint32 FlowField::unreachable;
+const Uint8 FlowField::step_cost;
+const Uint8 FlowField::brick_cost;
+
+FlowField::FlowField()
+{
+    m_rows_count = 0;
+    m_columns_count = 0;
+    m_target = {0, 0, 0, 0};
+    m_goal = {0, 0, 0, 0};
+}
+
+void FlowField::build(const Level& level, const SDL_Rect& target)
+{
+    m_rows_count = level.getRowsCount();
+    m_columns_count = level.getColumnsCount();
+    m_target = target;
+    m_cost.assign(m_rows_count * m_columns_count, 0);
+    m_distance.assign(m_rows_count * m_columns_count, unreachable);
+    if(m_rows_count == 0 || m_columns_count == 0) return;
+
+    // the node takes the most restrictive class of its fields: 0 - free, 1 - brick wall, 2 - blocked
+    const Uint8 class_cost[3] = {step_cost, brick_cost, 0};
+    const Tile* tiles = &level.at(0, 0);
+    Uint8* cost = m_cost.data();
+    for(int i = 0; i + 1 < m_rows_count; i++)
+        for(int j = 0; j + 1 < m_columns_count; j++)
+        {
+            const Tile* tile = tiles + i * m_columns_count + j;
+            Uint8 node_class = max(max(tileClass(tile[0].type), tileClass(tile[1].type)),
+                                   max(tileClass(tile[m_columns_count].type), tileClass(tile[m_columns_count + 1].type)));
+            cost[i * m_columns_count + j] = class_cost[node_class];
+        }
+
+    // goal: tanks closer to the target than half of a field, they face it and shoot at it
+    int tile_w = AppConfig::tile_rect.w, tile_h = AppConfig::tile_rect.h;
+    int row_start = max(0, (target.y - tile_h / 2) / tile_h - 1), row_end = min(m_rows_count - 1, (target.y + target.h + tile_h / 2 - 1) / tile_h);
+    int column_start = max(0, (target.x - tile_w / 2) / tile_w - 1), column_end = min(m_columns_count - 1, (target.x + target.w + tile_w / 2 - 1) / tile_w);
+    m_goal = {column_start, row_start, column_end - column_start + 1, row_end - row_start + 1};
+    for(auto& bucket : m_buckets) bucket.clear();
+    for(int i = row_start; i <= row_end; i++)
+        for(int j = column_start; j <= column_end; j++)
+        {
+            int index = i * m_columns_count + j;
+            if(m_cost[index] == 0) continue;
+            m_distance[index] = 0;
+            m_buckets[0].push_back(index);
+        }
+    propagate(0);
+}
+
+void FlowField::repair(const Level& level, const std::vector<int>& changed_tiles)
+{
+    if(!isBuilt()) return;
+    const std::greater<std::pair<Uint32, int>> heap_order;
+    Uint32* distance = m_distance.data();
+
+    // a field belongs to the nodes on its left and above it; nodes with a higher cost are checked by their old distance
+    m_heap.clear();
+    m_lost.clear();
+    for(int tile : changed_tiles)
+    {
+        int row = tile / m_columns_count, column = tile % m_columns_count;
+        for(int i = max(0, row - 1); i <= row; i++)
+            for(int j = max(0, column - 1); j <= column; j++)
+            {
+                int index = i * m_columns_count + j;
+                Uint8 cost = nodeCost(level, i, j);
+                if(cost == m_cost[index]) continue;
+                bool increased = (cost == 0 || (m_cost[index] != 0 && cost > m_cost[index]));
+                m_cost[index] = cost;
+                if(increased && distance[index] != unreachable) pushHeap(distance[index], index);
+                else if(!increased) m_lost.push_back(index);
+            }
+    }
+
+    // nodes are checked from the nearest one, so a node keeps its distance only if a neighbour that kept its distance supports it;
+    // a node without support loses its distance and its neighbours that could depend on it are checked too
+    size_t decreased_count = m_lost.size();
+    while(!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), heap_order);
+        int index = m_heap.back().second;
+        Uint32 old_distance = m_heap.back().first;
+        m_heap.pop_back();
+        if(distance[index] != old_distance) continue;
+        if(m_cost[index] != 0 && bestDistance(index) == old_distance) continue;
+
+        distance[index] = unreachable;
+        m_lost.push_back(index);
+        for(const auto& step : direction_step)
+        {
+            int r = index / m_columns_count + step[0], c = index % m_columns_count + step[1];
+            if(r < 0 || c < 0 || r >= m_rows_count || c >= m_columns_count) continue;
+            int next = r * m_columns_count + c;
+            // the cost of the neighbour may have changed too, so every farther neighbour is checked
+            if(m_cost[next] != 0 && distance[next] != unreachable && distance[next] > old_distance)
+                pushHeap(distance[next], next);
+        }
+    }
+
+    // nodes with a cheaper step and nodes which lost their distance start from their best neighbours
+    for(size_t i = 0; i < m_lost.size(); i++)
+    {
+        int index = m_lost[i];
+        if(m_cost[index] == 0) continue;
+        Uint32 best = bestDistance(index);
+        if(best < distance[index] || (i >= decreased_count && best != unreachable))
+        {
+            distance[index] = best;
+            pushHeap(best, index);
+        }
+    }
+
+    // Dijkstra's algorithm from the new distances, it stops at nodes whose distance does not decrease
+    while(!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), heap_order);
+        Uint32 current = m_heap.back().first;
+        int index = m_heap.back().second;
+        m_heap.pop_back();
+        if(distance[index] != current) continue;
+
+        for(const auto& step : direction_step)
+        {
+            int r = index / m_columns_count + step[0], c = index % m_columns_count + step[1];
+            if(r < 0 || c < 0 || r >= m_rows_count || c >= m_columns_count) continue;
+            int next = r * m_columns_count + c;
+            if(m_cost[next] == 0 || current + m_cost[next] >= distance[next]) continue;
+            distance[next] = current + m_cost[next];
+            pushHeap(distance[next], next);
+        }
+    }
+}
+
+void FlowField::clear()
+{
+    m_rows_count = 0;
+    m_columns_count = 0;
+    m_cost.clear();
+    m_distance.clear();
+}
+
+Uint32 FlowField::getDistance(double x, double y) const
+{
+    int index = nodeIndex(x, y);
+    return index < 0 ? unreachable : m_distance[index];
+}
+
+bool FlowField::getDirection(double x, double y, Direction& direction) const
+{
+    int index = nodeIndex(x, y);
+    if(index < 0 || m_distance[index] == 0 || m_distance[index] == unreachable) return false;
+
+    int row = index / m_columns_count, column = index % m_columns_count;
+    Uint32 best = m_distance[index];
+    for(int d = D_UP; d <= D_LEFT; d++)
+    {
+        int r = row + direction_step[d][0], c = column + direction_step[d][1];
+        if(r < 0 || c < 0 || r >= m_rows_count || c >= m_columns_count) continue;
+        Uint32 distance = m_distance[r * m_columns_count + c];
+        if(distance < best)
+        {
+            best = distance;
+            direction = static_cast<Direction>(d);
+        }
+    }
+    return best < m_distance[index];
+}
+
+Uint8 FlowField::tileClass(Uint8 type)
+{
+    if(type == ST_STONE_WALL || type == ST_WATER) return 2;
+    return type == ST_BRICK_WALL ? 1 : 0;
+}
+
+Uint8 FlowField::nodeCost(const Level& level, int row, int column)
+{
+    // the tank covers two rows and two columns
+    if(row + 1 >= level.getRowsCount() || column + 1 >= level.getColumnsCount()) return 0;
+    Uint8 cost = step_cost;
+    for(int i = row; i <= row + 1; i++)
+        for(int j = column; j <= column + 1; j++)
+        {
+            SpriteType type = level.getType(i, j);
+            if(type == ST_STONE_WALL || type == ST_WATER) return 0;
+            if(type == ST_BRICK_WALL) cost = brick_cost;
+        }
+    return cost;
+}
+
+int FlowField::nodeIndex(double x, double y) const
+{
+    int row = (int)(y + AppConfig::tile_rect.h / 2) / AppConfig::tile_rect.h;
+    int column = (int)(x + AppConfig::tile_rect.w / 2) / AppConfig::tile_rect.w;
+    if(y < 0 || x < 0 || row >= m_rows_count || column >= m_columns_count) return -1;
+    return row * m_columns_count + column;
+}
+
+void FlowField::propagate(unsigned current)
+{
+    const unsigned buckets_count = sizeof(m_buckets) / sizeof(m_buckets[0]);
+    const int nodes_count = m_cost.size();
+    const Uint8* cost = m_cost.data();
+    Uint32* distance = m_distance.data();
+    unsigned empty_count = 0;
+    // after a whole round of empty buckets no node is waiting
+    while(empty_count < buckets_count)
+    {
+        std::vector<int>& bucket = m_buckets[current % buckets_count];
+        if(bucket.empty())
+        {
+            empty_count++;
+            current++;
+            continue;
+        }
+        empty_count = 0;
+
+        int index = bucket.back();
+        bucket.pop_back();
+        // nodes are added again when their distance decreases, old entries are skipped
+        if(distance[index] != current) continue;
+
+        // nodes of the last row and the last column are blocked, so a step out of the map through the left or right edge
+        // lands on a blocked node and only the first and the last row need a check
+        const int neighbours[4] = {index - m_columns_count, index + 1, index + m_columns_count, index - 1};
+        for(int next : neighbours)
+        {
+            if(next < 0 || next >= nodes_count || cost[next] == 0) continue;
+            Uint32 next_distance = current + cost[next];
+            if(next_distance >= distance[next]) continue;
+            distance[next] = next_distance;
+            m_buckets[next_distance % buckets_count].push_back(next);
+        }
+    }
+}
+
+bool FlowField::isGoal(int index) const
+{
+    int row = index / m_columns_count, column = index % m_columns_count;
+    return row >= m_goal.y && row < m_goal.y + m_goal.h && column >= m_goal.x && column < m_goal.x + m_goal.w;
+}
+
+Uint32 FlowField::bestDistance(int index) const
+{
+    if(isGoal(index)) return 0;
+    int row = index / m_columns_count, column = index % m_columns_count;
+    Uint32 best = unreachable;
+    for(const auto& step : direction_step)
+    {
+        int r = row + step[0], c = column + step[1];
+        if(r < 0 || c < 0 || r >= m_rows_count || c >= m_columns_count) continue;
+        Uint32 distance = m_distance[r * m_columns_count + c];
+        if(distance != unreachable && distance + m_cost[index] < best) best = distance + m_cost[index];
+    }
+    return best;
+}
+
+void FlowField::pushHeap(Uint32 distance, int index)
+{
+    m_heap.push_back(std::make_pair(distance, index));
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<Uint32, int>>());
+}
@@ -0,0 +1,161 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "level.h"
+#include <vector>
+
+/**
+ * @brief
+ * Distances of all positions of a tank on the map to one target, shared by all enemies heading to that target.
+ * A position (node) is the top left field of the 2x2 fields covered by a tank. Stone walls and water block a node,
+ * brick walls only make it more expensive because enemies shoot through them. Distances are calculated with Dijkstra's
+ * algorithm using a bucket queue, since every step costs a small integer. An enemy reads the direction of its next step
+ * by comparing the distances of the four neighbouring nodes, so the cost does not depend on the number of enemies.
+ * When a few fields change, e.g. a brick wall is destroyed, the field is repaired around them instead of being built again:
+ * only nodes whose distance depends on the changed fields are visited.
+ */
+class FlowField
+{
+public:
+    FlowField();
+
+    /**
+     * Calculating the distances of all nodes to the target.
+     * Nodes of tanks touching the target are the goal with distance 0.
+     * @param level - map of the level
+     * @param target - rectangle of the target on the map, e.g. the eagle or a player
+     */
+    void build(const Level& level, const SDL_Rect& target);
+    /**
+     * Updating the distances after the types of some fields changed, the result is the same as after @a build.
+     * Nodes whose cost increased lose the distances depending on them and get new ones from their neighbours,
+     * then Dijkstra's algorithm continues from all nodes whose distance decreased.
+     * @param level - map of the level, it must have the size given to @a build
+     * @param changed_tiles - indexes of the changed fields in the map, they may repeat
+     */
+    void repair(const Level& level, const std::vector<int>& changed_tiles);
+    /**
+     * Removing all distances, the field has no target.
+     */
+    void clear();
+    /**
+     * @return @a true if the field was built for a target
+     */
+    bool isBuilt() const { return !m_distance.empty(); }
+    /**
+     * @return rectangle of the target given to @a build
+     */
+    const SDL_Rect& getTarget() const { return m_target; }
+    /**
+     * @return distances of all nodes row after row, e.g. to compare two fields
+     */
+    const std::vector<Uint32>& getDistances() const { return m_distance; }
+    /**
+     * @param x - horizontal position of the tank
+     * @param y - vertical position of the tank
+     * @return distance from the node nearest to the position, @a unreachable if the target cannot be reached from it
+     */
+    Uint32 getDistance(double x, double y) const;
+    /**
+     * Searching for the step towards the target from the node nearest to the position.
+     * @param x - horizontal position of the tank
+     * @param y - vertical position of the tank
+     * @param direction - set to the direction of the neighbouring node with the smallest distance
+     * @return @a false if the tank is at the goal or the target cannot be reached
+     */
+    bool getDirection(double x, double y, Direction& direction) const;
+
+    /**
+     * Distance of nodes from which the target cannot be reached.
+     */
+    static const Uint32 unreachable = 0xFFFFFFFF;
+    /**
+     * Cost of a step to a node without brick walls.
+     */
+    static const Uint8 step_cost = 1;
+    /**
+     * Cost of a step to a node with brick walls, the time to destroy them measured in steps.
+     */
+    static const Uint8 brick_cost = 5;
+
+private:
+    /**
+     * @param level - map of the level
+     * @param row - row of the node
+     * @param column - column of the node
+     * @return cost of a step to the node, 0 if the node is blocked
+     */
+    static Uint8 nodeCost(const Level& level, int row, int column);
+    /**
+     * @param type - type of a field
+     * @return 0 for fields passable by tanks, 1 for brick walls and 2 for fields blocking tanks
+     */
+    static Uint8 tileClass(Uint8 type);
+    /**
+     * @param x - horizontal position of the tank
+     * @param y - vertical position of the tank
+     * @return index of the node nearest to the position, -1 outside the map
+     */
+    int nodeIndex(double x, double y) const;
+    /**
+     * Running Dijkstra's algorithm from the nodes stored in the buckets until all buckets are empty.
+     * @param current - bucket of the smallest stored distance
+     */
+    void propagate(unsigned current);
+    /**
+     * @param index - index of the node
+     * @return @a true if the node touches the target
+     */
+    bool isGoal(int index) const;
+    /**
+     * @param index - index of the node
+     * @return smallest distance of the node through its neighbours with a known distance, 0 for a goal node
+     */
+    Uint32 bestDistance(int index) const;
+    /**
+     * Adding a node to @a m_heap.
+     * @param distance - distance of the node
+     * @param index - index of the node
+     */
+    void pushHeap(Uint32 distance, int index);
+
+    /**
+     * Number of rows of nodes, equal to the number of rows of the map.
+     */
+    int m_rows_count;
+    /**
+     * Number of columns of nodes, equal to the number of columns of the map.
+     */
+    int m_columns_count;
+    /**
+     * Rectangle of the target.
+     */
+    SDL_Rect m_target;
+    /**
+     * Goal nodes: the first column and row and the number of columns and rows.
+     */
+    SDL_Rect m_goal;
+    /**
+     * Cost of a step to every node, 0 for blocked nodes.
+     */
+    std::vector<Uint8> m_cost;
+    /**
+     * Distance of every node to the target.
+     */
+    std::vector<Uint32> m_distance;
+    /**
+     * Bucket queue of Dijkstra's algorithm: nodes waiting for processing by their distance modulo the number of buckets.
+     */
+    std::vector<int> m_buckets[brick_cost + 1];
+    /**
+     * Binary heap of pairs of distance and node used by @a repair, the smallest distance is on the top.
+     * Distances of repaired nodes are spread widely, so the bucket queue cannot be used there.
+     */
+    std::vector<std::pair<Uint32, int>> m_heap;
+    /**
+     * Nodes which lost their distance during @a repair.
+     */
+    std::vector<int> m_lost;
+};
+
+#endif // FLOWFIELD_H
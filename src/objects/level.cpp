@@ -0,0 +1,361 @@
+#include "level.h"
+#include "../appconfig.h"
+
+/**
+ * Standing quarters of a brick wall after a hit, indexed by the mask before the hit and the direction of the bullet.
+ * A hit removes the half of the standing part nearer to the bullet, or everything if the part is one quarter thick.
+ */
+static const Uint8 brick_hit[16][4] =
+{
+    // D_UP, D_RIGHT, D_DOWN, D_LEFT
+    { 0,  0,  0,  0},
+    { 0,  0,  0,  0},
+    { 0,  0,  0,  0},
+    { 0,  2,  0,  1},
+    { 0,  0,  0,  0},
+    { 1,  0,  4,  0},
+    { 2,  2,  4,  4},
+    { 3,  2,  4,  5},
+    { 0,  0,  0,  0},
+    { 1,  8,  8,  1},
+    { 2,  0,  8,  0},
+    { 3, 10,  8,  1},
+    { 0,  8,  0,  4},
+    { 1,  8, 12,  5},
+    { 2, 10, 12,  4},
+    { 3, 10, 12,  5}
+};
+
+/**
+ * Bounding box of standing quarters: x, y, width and height in halves of a field.
+ */
+static const Uint8 quarter_bounds[16][4] =
+{
+    {0, 0, 0, 0}, {0, 0, 1, 1}, {1, 0, 1, 1}, {0, 0, 2, 1},
+    {0, 1, 1, 1}, {0, 0, 1, 2}, {0, 0, 2, 2}, {0, 0, 2, 2},
+    {1, 1, 1, 1}, {0, 0, 2, 2}, {1, 0, 1, 2}, {0, 0, 2, 2},
+    {0, 1, 2, 1}, {0, 0, 2, 2}, {0, 0, 2, 2}, {0, 0, 2, 2}
+};
+
+/**
+ * Row of the brick wall texture showing the standing quarters, 255 for masks that a hit cannot produce.
+ */
+static const Uint8 brick_frame[16] = {255, 7, 5, 1, 8, 4, 255, 255, 6, 255, 2, 255, 3, 255, 255, 0};
+
+Level::Level(Engine* engine)
+{
+    m_engine = engine;
+    m_rows_count = 0;
+    m_columns_count = 0;
+    m_frame_display_time = 0;
+    m_redraw = true;
+    m_types_revision = 0;
+    m_type_changes_revision = 0;
+    m_tiles_revision = 0;
+    m_tile_changes_revision = 0;
+    m_row_words = 0;
+    m_column_words = 0;
+    for(auto& sprite : m_sprites) sprite = nullptr;
+}
+
+void Level::resize(int rows_count, int columns_count)
+{
+    m_rows_count = rows_count;
+    m_columns_count = columns_count;
+    m_frame_display_time = 0;
+    Tile empty = {ST_NONE, 0, 0};
+    m_tiles.assign(rows_count * columns_count, empty);
+    m_changed_tiles.clear();
+    m_redraw = true;
+    resetTypeChanges();
+    buildWalls();
+
+    SpriteConfig* config = m_engine->getSpriteConfig();
+    for(int type = ST_BRICK_WALL; type <= ST_ICE; type++)
+        m_sprites[type - ST_BRICK_WALL] = config->getSpriteData(static_cast<SpriteType>(type));
+}
+
+void Level::clear()
+{
+    m_tiles.clear();
+    m_changed_tiles.clear();
+    m_rows_count = 0;
+    m_columns_count = 0;
+    resetTypeChanges();
+    buildWalls();
+}
+
+void Level::set(int row, int column, SpriteType type)
+{
+    int index = row * m_columns_count + column;
+    Tile& tile = m_tiles[index];
+    Uint8 quarters = (type == ST_NONE ? 0 : TQ_FULL);
+    if(tile.type == type && tile.quarters == quarters && tile.frame == 0) return;
+
+    bool type_changed = (tile.type != type), quarters_changed = (tile.quarters != quarters);
+    tile.type = type;
+    tile.quarters = quarters;
+    tile.frame = 0;
+    if(type_changed) markTypeChanged(index);
+    if(type_changed || quarters_changed) markTileChanged(index);
+    markChanged(index);
+}
+
+SDL_Rect Level::collisionRect(int row, int column) const
+{
+    const Uint8* bounds = quarter_bounds[at(row, column).quarters];
+    int half_w = AppConfig::tile_rect.w / 2;
+    int half_h = AppConfig::tile_rect.h / 2;
+    if(bounds[2] == 0) return {0, 0, 0, 0};
+    return {column * AppConfig::tile_rect.w + bounds[0] * half_w, row * AppConfig::tile_rect.h + bounds[1] * half_h, bounds[2] * half_w, bounds[3] * half_h};
+}
+
+void Level::bulletHit(int row, int column, Direction bullet_direction)
+{
+    int index = row * m_columns_count + column;
+    Tile& tile = m_tiles[index];
+    if(tile.type != ST_BRICK_WALL) return;
+
+    tile.quarters = brick_hit[tile.quarters][bullet_direction];
+    if(tile.quarters == 0)
+    {
+        tile.type = ST_NONE;
+        markTypeChanged(index);
+    }
+    markTileChanged(index);
+    markChanged(index);
+}
+
+void Level::update(Uint32 dt)
+{
+    // water is the only animated field, all water fields show the same frame
+    const SpriteData* water = getSprite(ST_WATER);
+    if(water == nullptr || water->frames_count <= 1) return;
+
+    m_frame_display_time += dt;
+    if(m_frame_display_time <= water->frame_duration) return;
+    m_frame_display_time = 0;
+    for(unsigned i = 0; i < m_tiles.size(); i++)
+    {
+        Tile& tile = m_tiles[i];
+        if(tile.type != ST_WATER) continue;
+        Uint8 frame = tile.frame + 1;
+        if(frame >= water->frames_count) frame = water->loop ? 0 : water->frames_count - 1;
+        if(frame == tile.frame) continue;
+        tile.frame = frame;
+        markChanged(i);
+    }
+}
+
+void Level::draw()
+{
+    Renderer* renderer = m_engine->getRenderer();
+    SDL_Rect map_rect = {0, 0, m_columns_count * AppConfig::tile_rect.w, m_rows_count * AppConfig::tile_rect.h};
+    if(m_tiles.empty() || renderer == nullptr) return;
+
+    bool created = false;
+    if(!renderer->beginLayer(map_rect.w, map_rect.h, created))
+    {
+        for(unsigned i = 0; i < m_tiles.size(); i++) drawTile(i, renderer);
+        return;
+    }
+
+    if(m_redraw || created)
+    {
+        renderer->clearLayer(nullptr);
+        for(unsigned i = 0; i < m_tiles.size(); i++) drawTile(i, renderer);
+    }
+    else
+    {
+        // all fields are cleared first, so the changed fields are drawn with one batch
+        for(int index : m_changed_tiles)
+        {
+            SDL_Rect dest = {index % m_columns_count * AppConfig::tile_rect.w, index / m_columns_count * AppConfig::tile_rect.h, AppConfig::tile_rect.w, AppConfig::tile_rect.h};
+            renderer->clearLayer(&dest);
+        }
+        for(int index : m_changed_tiles) drawTile(index, renderer);
+    }
+    renderer->endLayer();
+    m_changed_tiles.clear();
+    m_redraw = false;
+
+    renderer->drawLayer(&map_rect);
+}
+
+void Level::saveState(Snapshot& snapshot) const
+{
+    snapshot.write(m_rows_count);
+    snapshot.write(m_columns_count);
+    snapshot.write(m_frame_display_time);
+    snapshot.writeBytes(m_tiles.data(), m_tiles.size() * sizeof(Tile));
+}
+
+bool Level::loadState(SnapshotReader& reader)
+{
+    int rows_count = 0, columns_count = 0;
+    reader.read(rows_count);
+    reader.read(columns_count);
+    if(reader.error() || rows_count < 0 || columns_count < 0 || (size_t)rows_count * columns_count > reader.remaining()) return false;
+    if(rows_count != m_rows_count || columns_count != m_columns_count) resize(rows_count, columns_count);
+    m_changed_tiles.clear();
+    m_redraw = true;
+    resetTypeChanges();
+    reader.read(m_frame_display_time);
+    reader.readBytes(m_tiles.data(), m_tiles.size() * sizeof(Tile));
+    if(reader.error()) return false;
+
+    for(auto& tile : m_tiles)
+    {
+        if(tile.type == ST_NONE)
+        {
+            if(tile.quarters != 0) return false;
+            continue;
+        }
+        const SpriteData* sprite = getSprite(tile.type);
+        if(sprite == nullptr || tile.type == ST_BUSH || tile.frame >= sprite->frames_count) return false;
+        if(tile.quarters > TQ_FULL) return false;
+        if(tile.type == ST_BRICK_WALL && brick_frame[tile.quarters] == 255) return false;
+        if(tile.type != ST_BRICK_WALL && tile.quarters != TQ_FULL) return false;
+    }
+    buildWalls();
+    return true;
+}
+
+const SpriteData* Level::getSprite(Uint8 type) const
+{
+    if(type < ST_BRICK_WALL || type > ST_ICE) return nullptr;
+    return m_sprites[type - ST_BRICK_WALL];
+}
+
+void Level::drawTile(int index, Renderer* renderer) const
+{
+    const Tile& tile = m_tiles[index];
+    if(tile.type == ST_NONE) return;
+
+    const SDL_Rect& src = getSprite(tile.type)->frameRect(0, tile.type == ST_BRICK_WALL ? brick_frame[tile.quarters] : tile.frame);
+    SDL_Rect dest = {index % m_columns_count * AppConfig::tile_rect.w, index / m_columns_count * AppConfig::tile_rect.h, AppConfig::tile_rect.w, AppConfig::tile_rect.h};
+    renderer->drawObject(&src, &dest);
+}
+
+bool Level::getTypeChanges(Uint32 revision, std::vector<int>& changes) const
+{
+    // revisions before the first remembered change cannot be repeated
+    Uint32 first = revision - m_type_changes_revision;
+    if(first > m_type_changes.size()) return false;
+    changes.insert(changes.end(), m_type_changes.begin() + first, m_type_changes.end());
+    return true;
+}
+
+void Level::forgetTypeChanges()
+{
+    m_type_changes.clear();
+    m_type_changes_revision = m_types_revision;
+}
+
+void Level::markTypeChanged(int index)
+{
+    updateWalls(index);
+    m_types_revision++;
+    // nobody reads the changes, e.g. a map built without a game, so they are forgotten instead of growing forever
+    if(m_type_changes.size() >= m_tiles.size()) forgetTypeChanges();
+    else m_type_changes.push_back(index);
+}
+
+void Level::markTileChanged(int index)
+{
+    m_tiles_revision++;
+    if(m_tile_changes.size() >= m_tiles.size())
+    {
+        m_tile_changes.clear();
+        m_tile_changes_revision = m_tiles_revision;
+    }
+    else m_tile_changes.push_back(index);
+}
+
+bool Level::getTileChanges(Uint32 revision, std::vector<int>& changes) const
+{
+    Uint32 first = revision - m_tile_changes_revision;
+    if(first > m_tile_changes.size()) return false;
+    changes.insert(changes.end(), m_tile_changes.begin() + first, m_tile_changes.end());
+    return true;
+}
+
+void Level::resetTypeChanges()
+{
+    m_types_revision++;
+    m_type_changes.clear();
+    m_type_changes_revision = m_types_revision;
+    m_tiles_revision++;
+    m_tile_changes.clear();
+    m_tile_changes_revision = m_tiles_revision;
+}
+
+/**
+ * @param words - bits of a row or a column
+ * @param first - first checked bit
+ * @param last - last checked bit
+ * @return @a true if all bits from @a first to @a last are zero
+ */
+static bool bitsClear(const Uint64* words, int first, int last)
+{
+    int first_word = first / 64, last_word = last / 64;
+    Uint64 first_mask = ~Uint64(0) << (first % 64);
+    Uint64 last_mask = ~Uint64(0) >> (63 - last % 64);
+    if(first_word == last_word) return (words[first_word] & first_mask & last_mask) == 0;
+    if(words[first_word] & first_mask) return false;
+    for(int i = first_word + 1; i < last_word; i++)
+        if(words[i]) return false;
+    return (words[last_word] & last_mask) == 0;
+}
+
+bool Level::rowClear(int row, int first_column, int last_column) const
+{
+    return bitsClear(&m_row_walls[row * m_row_words], first_column, last_column);
+}
+
+bool Level::columnClear(int column, int first_row, int last_row) const
+{
+    return bitsClear(&m_column_walls[column * m_column_words], first_row, last_row);
+}
+
+void Level::updateWalls(int index)
+{
+    int row = index / m_columns_count, column = index % m_columns_count;
+    Uint64 row_bit = Uint64(1) << (column % 64), column_bit = Uint64(1) << (row % 64);
+    Uint64& row_word = m_row_walls[row * m_row_words + column / 64];
+    Uint64& column_word = m_column_walls[column * m_column_words + row / 64];
+    Uint8 type = m_tiles[index].type;
+    if(type == ST_BRICK_WALL || type == ST_STONE_WALL)
+    {
+        row_word |= row_bit;
+        column_word |= column_bit;
+    }
+    else
+    {
+        row_word &= ~row_bit;
+        column_word &= ~column_bit;
+    }
+}
+
+void Level::buildWalls()
+{
+    m_row_words = (m_columns_count + 63) / 64;
+    m_column_words = (m_rows_count + 63) / 64;
+    m_row_walls.assign(m_rows_count * m_row_words, 0);
+    m_column_walls.assign(m_columns_count * m_column_words, 0);
+    for(int i = 0; i < (int)m_tiles.size(); i++)
+        if(m_tiles[i].type == ST_BRICK_WALL || m_tiles[i].type == ST_STONE_WALL) updateWalls(i);
+}
+
+void Level::markChanged(int index)
+{
+    if(m_redraw) return;
+    // without drawing, e.g. in the headless simulation, the list would grow forever
+    if(m_changed_tiles.size() >= m_tiles.size())
+    {
+        m_changed_tiles.clear();
+        m_redraw = true;
+        return;
+    }
+    m_changed_tiles.push_back(index);
+}
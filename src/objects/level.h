@@ -0,0 +1,295 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "../engine/engine.h"
+#include "../engine/snapshot.h"
+#include "../type.h"
+#include <vector>
+
+/**
+ * Quarters of a field, combined into the mask of the standing parts of a brick wall.
+ */
+enum TileQuarter
+{
+    TQ_TOP_LEFT = 1 << 0,
+    TQ_TOP_RIGHT = 1 << 1,
+    TQ_BOTTOM_LEFT = 1 << 2,
+    TQ_BOTTOM_RIGHT = 1 << 3,
+    TQ_FULL = 15
+};
+
+/**
+ * @brief
+ * One field of the map. The position of the field follows from its index, so it stores only a few bytes and the whole map fits in a few kilobytes.
+ */
+struct Tile
+{
+    /**
+     * Type of the field: @a ST_BRICK_WALL, @a ST_STONE_WALL, @a ST_WATER, @a ST_ICE or @a ST_NONE for an empty field.
+     */
+    Uint8 type;
+    /**
+     * Mask of @a TileQuarter values of the standing parts of a brick wall. Other obstacles are always @a TQ_FULL and an empty field is 0.
+     */
+    Uint8 quarters;
+    /**
+     * Number of the displayed animation frame.
+     */
+    Uint8 frame;
+};
+
+/**
+ * @brief
+ * Map of the level stored in a single contiguous array of tiles, row after row.
+ * Tiles are not separate objects: their collision rectangles and textures are calculated from the type and the standing quarters when they are needed.
+ * Bushes are drawn above tanks, so they are not part of this map.
+ * The map is drawn into a layer texture of the renderer once and only the changed fields are drawn again,
+ * so a frame needs one copy of the layer instead of one copy per field.
+ * Fields stopping bullets are also kept as bits of every row and every column, so checking whether a shot along a row or a column
+ * is free needs only a few word operations.
+ */
+class Level
+{
+public:
+    /**
+     * Creating an empty map.
+     * @param engine - context of the game the map belongs to, giving the animations of fields and the renderer
+     */
+    Level(Engine* engine);
+
+    /**
+     * Changing the size of the map and clearing all fields.
+     * @param rows_count - number of rows
+     * @param columns_count - number of columns
+     */
+    void resize(int rows_count, int columns_count);
+    /**
+     * Removing all fields, the map has size 0.
+     */
+    void clear();
+    /**
+     * @return number of rows of the map
+     */
+    int getRowsCount() const { return m_rows_count; }
+    /**
+     * @return number of columns of the map
+     */
+    int getColumnsCount() const { return m_columns_count; }
+    /**
+     * @param row - row of the field
+     * @param column - column of the field
+     * @return field of the map, the position has to be inside the map
+     */
+    const Tile& at(int row, int column) const { return m_tiles[row * m_columns_count + column]; }
+    /**
+     * @param row - row of the field
+     * @param column - column of the field
+     * @return type of the field
+     */
+    SpriteType getType(int row, int column) const { return static_cast<SpriteType>(at(row, column).type); }
+    /**
+     * Placing a new undamaged obstacle in the field or clearing the field.
+     * @param row - row of the field
+     * @param column - column of the field
+     * @param type - type of the obstacle or @a ST_NONE
+     */
+    void set(int row, int column, SpriteType type);
+    /**
+     * The function returns the rectangle of the field that stops tanks and bullets. It is smaller than the field for damaged brick walls.
+     * @param row - row of the field
+     * @param column - column of the field
+     * @return collision rectangle in map coordinates, empty for an empty field
+     */
+    SDL_Rect collisionRect(int row, int column) const;
+    /**
+     * @return number increased every time the type of a field changes, e.g. when a wall is built or destroyed
+     */
+    Uint32 getTypesRevision() const { return m_types_revision; }
+    /**
+     * Reading the fields whose type changed after the given revision.
+     * @param revision - value of @a getTypesRevision at the last check
+     * @param changes - indexes of the changed fields are appended to it, a field may appear many times
+     * @return @a false if the changes are not remembered, e.g. after loading a map or calling @a forgetTypeChanges
+     */
+    bool getTypeChanges(Uint32 revision, std::vector<int>& changes) const;
+    /**
+     * Removing the remembered fields whose type changed, the next @a getTypeChanges sees only later changes.
+     */
+    void forgetTypeChanges();
+    /**
+     * @return number increased every time the type or the standing part of a field changes, e.g. when a bullet hits a brick wall
+     */
+    Uint32 getTilesRevision() const { return m_tiles_revision; }
+    /**
+     * Reading the fields whose type or standing part changed after the given revision. These changes are not removed
+     * by @a forgetTypeChanges, only when there are more of them than fields.
+     * @param revision - value of @a getTilesRevision at the last check
+     * @param changes - indexes of the changed fields are appended to it, a field may appear many times
+     * @return @a false if the changes are not remembered, e.g. after loading a map
+     */
+    bool getTileChanges(Uint32 revision, std::vector<int>& changes) const;
+    /**
+     * Checking a part of a row with one word operation per 64 fields.
+     * @param row - row of the fields
+     * @param first_column - first checked column
+     * @param last_column - last checked column, not smaller than @a first_column
+     * @return @a true if no field in the range stops bullets
+     */
+    bool rowClear(int row, int first_column, int last_column) const;
+    /**
+     * Checking a part of a column with one word operation per 64 fields.
+     * @param column - column of the fields
+     * @param first_row - first checked row
+     * @param last_row - last checked row, not smaller than @a first_row
+     * @return @a true if no field in the range stops bullets
+     */
+    bool columnClear(int column, int first_row, int last_row) const;
+    /**
+     * Removing the part of a brick wall facing the bullet: half of the wall after the first hit, and the wall is removed
+     * when the standing part is only one quarter thick in the direction of the bullet.
+     * @param row - row of the field
+     * @param column - column of the field
+     * @param bullet_direction - the direction of bullet movement
+     */
+    void bulletHit(int row, int column, Direction bullet_direction);
+
+    /**
+     * Counting the display time of animation frames of water.
+     * @param dt - time since the last function call
+     */
+    void update(Uint32 dt);
+    /**
+     * Drawing the fields changed since the last call into the layer texture and drawing the layer onto the screen.
+     * If the renderer does not support layers, all fields are drawn with the @a drawObject method from the @a Renderer class.
+     * Nothing is drawn if the context has no renderer.
+     */
+    void draw();
+
+    /**
+     * Appending the size of the map, the animation time and all fields.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the map written by @a saveState.
+     * @param reader - buffer of the saved game
+     * @return @a false if the data are not a valid map
+     */
+    bool loadState(SnapshotReader& reader);
+
+private:
+    /**
+     * @param type - type of the field
+     * @return animation of the field type, @a nullptr for an empty field
+     */
+    const SpriteData* getSprite(Uint8 type) const;
+    /**
+     * Drawing one field at its position on the map.
+     * @param index - index of the field in @a m_tiles
+     * @param renderer - renderer of the engine
+     */
+    void drawTile(int index, Renderer* renderer) const;
+    /**
+     * Remembering a field to be drawn again in the layer.
+     * @param index - index of the field in @a m_tiles
+     */
+    void markChanged(int index);
+    /**
+     * Increasing the revision of field types and remembering the changed field.
+     * @param index - index of the field in @a m_tiles
+     */
+    void markTypeChanged(int index);
+    /**
+     * Increasing the revision of fields when the type or the standing part of a field changes and remembering the field.
+     * @param index - index of the field in @a m_tiles
+     */
+    void markTileChanged(int index);
+    /**
+     * Increasing the revisions of field types and of fields when the whole map changes, the remembered fields are removed.
+     */
+    void resetTypeChanges();
+    /**
+     * Setting the bits of a field in @a m_row_walls and @a m_column_walls according to its type.
+     * @param index - index of the field in @a m_tiles
+     */
+    void updateWalls(int index);
+    /**
+     * Calculating @a m_row_walls and @a m_column_walls for all fields.
+     */
+    void buildWalls();
+
+    /**
+     * Fields of the map, row after row.
+     */
+    std::vector<Tile> m_tiles;
+    /**
+     * Number of rows.
+     */
+    int m_rows_count;
+    /**
+     * Number of columns.
+     */
+    int m_columns_count;
+    /**
+     * Display time of the current frame of animated fields. All of them change frames together.
+     */
+    Uint32 m_frame_display_time;
+    /**
+     * Context of the game the map belongs to.
+     */
+    Engine* m_engine;
+    /**
+     * Animations of field types from @a ST_BRICK_WALL to @a ST_ICE.
+     */
+    const SpriteData* m_sprites[ST_ICE - ST_BRICK_WALL + 1];
+    /**
+     * Indexes of fields changed since the last @a draw.
+     */
+    std::vector<int> m_changed_tiles;
+    /**
+     * Variable stores whether all fields have to be drawn again, e.g. after loading a map.
+     */
+    bool m_redraw;
+    /**
+     * Number of changes of field types, it lets users of the map notice that obstacles changed.
+     */
+    Uint32 m_types_revision;
+    /**
+     * Indexes of fields whose type changed after the revision @a m_type_changes_revision, one entry per revision.
+     */
+    std::vector<int> m_type_changes;
+    /**
+     * Revision of field types before the first remembered change.
+     */
+    Uint32 m_type_changes_revision;
+    /**
+     * Number of changes of field types and of standing parts of brick walls.
+     */
+    Uint32 m_tiles_revision;
+    /**
+     * Indexes of fields whose type or standing part changed after the revision @a m_tile_changes_revision, one entry per revision.
+     */
+    std::vector<int> m_tile_changes;
+    /**
+     * Revision of fields before the first remembered change in @a m_tile_changes.
+     */
+    Uint32 m_tile_changes_revision;
+    /**
+     * Bits of fields stopping bullets, i.e. brick and stone walls, row after row; every row starts a new 64-bit word.
+     */
+    std::vector<Uint64> m_row_walls;
+    /**
+     * The same bits as in @a m_row_walls stored column after column.
+     */
+    std::vector<Uint64> m_column_walls;
+    /**
+     * Number of words of one row in @a m_row_walls.
+     */
+    int m_row_words;
+    /**
+     * Number of words of one column in @a m_column_walls.
+     */
+    int m_column_words;
+};
+
+#endif // LEVEL_H
@@ -9,18 +9,20 @@ Object::Object()
     pos_y = 0.0;
     type = ST_NONE;
     to_erase = false;
+    m_engine = nullptr;
     m_sprite = nullptr;
     m_frame_display_time = 0;
     m_current_frame = 0;
 }
 
-Object::Object(double x, double y, SpriteType type)
+Object::Object(Engine* engine, double x, double y, SpriteType type)
 {
     pos_x = x;
     pos_y = y;
     this->type = type;
     to_erase = false;
-    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(type);
+    m_engine = engine;
+    m_sprite = m_engine->getSpriteConfig()->getSpriteData(type);
     m_frame_display_time = 0;
     m_current_frame = 0;
 
@@ -40,12 +42,13 @@ Object::Object(double x, double y, SpriteType type)
     collision_rect.w = m_sprite->rect.w;
 }
 
-Object::Object(double x, double y, const SpriteData *sprite)
+Object::Object(Engine* engine, double x, double y, const SpriteData *sprite)
 {
     pos_x = x;
     pos_y = y;
     this->type = type;
     to_erase = false;
+    m_engine = engine;
     m_sprite = sprite;
     m_frame_display_time = 0;
     m_current_frame = 0;
@@ -72,8 +75,8 @@ Object::~Object()
 
 void Object::draw()
 {
-    if(m_sprite == nullptr || to_erase) return;
-    Engine::getEngine().getRenderer()->drawObject(&src_rect, &dest_rect);
+    if(m_sprite == nullptr || to_erase || m_engine->getRenderer() == nullptr) return;
+    m_engine->getRenderer()->drawObject(&src_rect, &dest_rect);
 }
 
 void Object::update(Uint32 dt)
@@ -103,23 +106,52 @@ void Object::update(Uint32 dt)
                 else m_current_frame = m_sprite->frames_count - 1;
             }
 
-            src_rect = moveRect(m_sprite->rect, 0, m_current_frame);
+            src_rect = m_sprite->frameRect(0, m_current_frame);
         }
     }
 }
 
-SDL_Rect Object::moveRect(const SDL_Rect &rect, int x, int y)
+void Object::resetAnimation()
 {
-    SDL_Rect r;
-    r.x = rect.x + x*rect.w;
-    r.y = rect.y + y*rect.h;
-    r.w = rect.w;
-    r.h = rect.h;
+    m_frame_display_time = 0;
+    m_current_frame = 0;
+}
+
+void Object::saveState(Snapshot& snapshot) const
+{
+    snapshot.write(to_erase);
+    snapshot.write(static_cast<Sint32>(type));
+    snapshot.write(static_cast<Sint32>(m_sprite == nullptr ? ST_NONE : m_sprite->type));
+    snapshot.write(pos_x);
+    snapshot.write(pos_y);
+    snapshot.write(collision_rect);
+    snapshot.write(dest_rect);
+    snapshot.write(src_rect);
+    snapshot.write(m_frame_display_time);
+    snapshot.write(m_current_frame);
+}
 
-    return r;
+void Object::loadState(SnapshotReader& reader)
+{
+    Sint32 object_type = ST_NONE, sprite_type = ST_NONE;
+    reader.read(to_erase);
+    reader.read(object_type);
+    reader.read(sprite_type);
+    reader.read(pos_x);
+    reader.read(pos_y);
+    reader.read(collision_rect);
+    reader.read(dest_rect);
+    reader.read(src_rect);
+    reader.read(m_frame_display_time);
+    reader.read(m_current_frame);
+
+    type = static_cast<SpriteType>(object_type);
+    if(sprite_type == ST_NONE) m_sprite = nullptr;
+    else m_sprite = m_engine->getSpriteConfig()->getSpriteData(static_cast<SpriteType>(sprite_type));
 }
 
 
+
 SDL_Rect intersectRect(SDL_Rect *rect1, SDL_Rect *rect2)
 {
     SDL_Rect intersect_rect;
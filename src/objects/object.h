@@ -2,6 +2,7 @@
 #define OBJECT_H
 
 #include "../engine/engine.h"
+#include "../engine/snapshot.h"
 
 /**
  * @brief
@@ -16,22 +17,25 @@ public:
     Object();
     /**
      * Creating an object.
+     * @param engine - context of the game the object belongs to, its animations are taken from the sprite configuration of the context
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param type - type of object
      */
-    Object(double x, double y, SpriteType type);
+    Object(Engine* engine, double x, double y, SpriteType type);
     /**
      * Creating an object.
+     * @param engine - context of the game the object belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param sprite - animation of the object of a given type
      */
-    Object(double x, double y, const SpriteData* sprite);
+    Object(Engine* engine, double x, double y, const SpriteData* sprite);
     virtual ~Object();
 
     /**
      * Drawing using the @a drawObject method from the @a Renderer class, the object from the texture at src_rect coordinates in the map area at dest_rect coordinates.
+     * Nothing is drawn if the context has no renderer.
      */
     virtual void draw();
     /**
@@ -40,6 +44,22 @@ public:
      */
     virtual void update(Uint32 dt);
 
+    /**
+     * Restarting the current animation from its first frame.
+     */
+    void resetAnimation();
+    /**
+     * Appending the whole state of the object to a snapshot: position, rectangles, animation and type.
+     * Derived classes append their own fields after the fields of the base class.
+     * @param snapshot - buffer of the saved game
+     */
+    virtual void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState.
+     * @param reader - buffer of the saved game
+     */
+    virtual void loadState(SnapshotReader& reader);
+
     /**
      * Variable says whether the object is to be deleted. If the change is equal to @a true, then updating and drawing the object is skipped.
      */
@@ -70,15 +90,11 @@ public:
     double pos_y;
 
 protected:
+
     /**
-     * The function returns a rectangle shifted by multiples of the size of the rectangle rect.
-     * @param rect - base rectangle
-     * @param x - horizontal shift
-     * @param y - vertical shift
-      * @return shifted rectangle
+     * Context of the game the object belongs to, @a nullptr for an object created by the default constructor.
      */
-    SDL_Rect moveRect(const SDL_Rect &rect, int x, int y);
-
+    Engine* m_engine;
     /**
      * Animation corresponding to a given object type.
      */
@@ -3,56 +3,62 @@
 #include <SDL2/SDL.h>
 #include <iostream>
 
-Player::Player()
-    : Tank(AppConfig::player_starting_point.at(0).x, AppConfig::player_starting_point.at(0).y, ST_PLAYER_1)
+Player::Player(Engine* engine, const GameConfig* config)
+    : Tank(engine, config->player_starting_point.at(0).x, config->player_starting_point.at(0).y, ST_PLAYER_1, config)
 {
     speed = 0;
     lives_count = 11;
-    m_bullet_max_size = AppConfig::player_bullet_max_size;
+    m_bullet_max_size = m_config->player_bullet_max_size;
     score = 0;
+    input = 0;
+    external_input = false;
     star_count = 0;
-    m_shield = new Object(0, 0, ST_SHIELD);
+    m_fire_time = 0;
+    m_shield = new Object(m_engine, 0, 0, ST_SHIELD);
     m_shield_time = 0;
     respawn();
 }
 
-Player::Player(double x, double y, SpriteType type)
-    : Tank(x, y, type)
+Player::Player(Engine* engine, double x, double y, SpriteType type, const GameConfig* config)
+    : Tank(engine, x, y, type, config)
 {
    speed = 0;
    lives_count = 11;
-   m_bullet_max_size = AppConfig::player_bullet_max_size;
+   m_bullet_max_size = m_config->player_bullet_max_size;
    score = 0;
+   input = 0;
+   external_input = false;
    star_count = 0;
-   m_shield = new Object(x, y, ST_SHIELD);
+   m_fire_time = 0;
+   m_shield = new Object(m_engine, x, y, ST_SHIELD);
    m_shield_time = 0;
    respawn();
 }
 
 void Player::update(Uint32 dt)
 {
-    const Uint8 *key_state = SDL_GetKeyboardState(NULL);
+    if(!external_input) input = readKeyboard();
 
     Tank::update(dt);
 
-    if(key_state != nullptr && !testFlag(TSF_MENU))
+    if(!testFlag(TSF_MENU))
     {
-        if(key_state[player_keys.up])
+        if(input & PI_UP)
         {
             setDirection(D_UP);
             speed = default_speed;
         }
-        else if(key_state[player_keys.down])
+        else if(input & PI_DOWN)
         {
             setDirection(D_DOWN);
             speed = default_speed;
         }
-        else if(key_state[player_keys.left])
+        else if(input & PI_LEFT)
         {
             setDirection(D_LEFT);
             speed = default_speed;
         }
-        else if(key_state[player_keys.right])
+        else if(input & PI_RIGHT)
         {
             setDirection(D_RIGHT);
             speed = default_speed;
@@ -63,7 +69,7 @@ void Player::update(Uint32 dt)
                 speed = 0.0;
         }
 
-        if(key_state[player_keys.fire] && m_fire_time > AppConfig::player_reload_time)
+        if((input & PI_FIRE) && m_fire_time > m_config->player_reload_time)
         {
             fire();
             m_fire_time = 0;
@@ -73,9 +79,9 @@ void Player::update(Uint32 dt)
     m_fire_time += dt;
 
     if(testFlag(TSF_LIFE))
-        src_rect = moveRect(m_sprite->rect, (testFlag(TSF_ON_ICE) ? new_direction : direction), m_current_frame + 2 * star_count);
+        src_rect = m_sprite->frameRect((testFlag(TSF_ON_ICE) ? new_direction : direction), m_current_frame + 2 * star_count);
     else
-        src_rect = moveRect(m_sprite->rect, 0, m_current_frame + 2 * star_count);
+        src_rect = m_sprite->frameRect(0, m_current_frame + 2 * star_count);
 
     stop = false;
 }
@@ -91,13 +97,13 @@ void Player::respawn()
 
     if(type == ST_PLAYER_1)
     {
-        pos_x = AppConfig::player_starting_point.at(0).x;
-        pos_y = AppConfig::player_starting_point.at(0).y;
+        pos_x = m_config->player_starting_point.at(0).x;
+        pos_y = m_config->player_starting_point.at(0).y;
     }
     else
     {
-        pos_x = AppConfig::player_starting_point.at(1).x;
-        pos_y = AppConfig::player_starting_point.at(1).y;
+        pos_x = m_config->player_starting_point.at(1).x;
+        pos_y = m_config->player_starting_point.at(1).y;
     }
 
     dest_rect.x = pos_x;
@@ -106,10 +112,10 @@ void Player::respawn()
     dest_rect.w = m_sprite->rect.w;
 
     setDirection(D_UP);
-    Mix_PlayChannel(SND_start, AppConfig::sounds[SND_start], 0);
+    if(AppConfig::sounds[SND_start] != nullptr) Mix_PlayChannel(SND_start, AppConfig::sounds[SND_start], 0);
     Tank::respawn();
     setFlag(TSF_SHIELD);
-    m_shield_time = AppConfig::tank_shield_time / 2;
+    m_shield_time = m_config->tank_shield_time / 2;
 }
 
 void Player::destroy()
@@ -135,13 +141,69 @@ Bullet* Player::fire()
     Bullet* b = Tank::fire();
     if(b != nullptr)
     {
-        Mix_PlayChannel(SND_fire, AppConfig::sounds[SND_fire], 0);
-        if(star_count > 0) b->speed = AppConfig::bullet_default_speed * 1.3;
+        if(AppConfig::sounds[SND_fire] != nullptr) Mix_PlayChannel(SND_fire, AppConfig::sounds[SND_fire], 0);
+        if(star_count > 0) b->speed = m_config->bullet_default_speed * 1.3;
         if(star_count == 3) b->increased_damage = true;
     }
     return b;
 }
 
+Player::Progress Player::getProgress() const
+{
+    Progress progress;
+    progress.lives_count = lives_count;
+    progress.score = score;
+    progress.star_count = star_count;
+    progress.bullet_max_size = m_bullet_max_size;
+    return progress;
+}
+
+void Player::setProgress(const Progress& progress)
+{
+    lives_count = progress.lives_count;
+    score = progress.score;
+    star_count = progress.star_count;
+    m_bullet_max_size = progress.bullet_max_size;
+
+    if(star_count > 0) default_speed = m_config->tank_default_speed * 1.3;
+    else default_speed = m_config->tank_default_speed;
+}
+
+void Player::saveState(Snapshot& snapshot) const
+{
+    Tank::saveState(snapshot);
+    snapshot.write(score);
+    snapshot.write(input);
+    snapshot.write(external_input);
+    snapshot.write(star_count);
+    snapshot.write(m_fire_time);
+}
+
+void Player::loadState(SnapshotReader& reader)
+{
+    Tank::loadState(reader);
+    reader.read(score);
+    reader.read(input);
+    reader.read(external_input);
+    reader.read(star_count);
+    reader.read(m_fire_time);
+    player_keys = AppConfig::player_keys.at(type == ST_PLAYER_1 ? 0 : 1);
+}
+
+PlayerInputs Player::readKeyboard() const
+{
+    const Uint8 *key_state = SDL_GetKeyboardState(NULL);
+    PlayerInputs keys = 0;
+    if(key_state == nullptr) return keys;
+
+    if(key_state[player_keys.up]) keys |= PI_UP;
+    if(key_state[player_keys.down]) keys |= PI_DOWN;
+    if(key_state[player_keys.left]) keys |= PI_LEFT;
+    if(key_state[player_keys.right]) keys |= PI_RIGHT;
+    if(key_state[player_keys.fire]) keys |= PI_FIRE;
+    return keys;
+}
+
 void Player::changeStarCountBy(int c)
 {
     star_count += c;
@@ -151,6 +213,6 @@ void Player::changeStarCountBy(int c)
     if(star_count >= 2 && c > 0) m_bullet_max_size++;
     else m_bullet_max_size = 2;
 
-    if(star_count > 0) default_speed = AppConfig::tank_default_speed * 1.3;
-    else default_speed = AppConfig::tank_default_speed;
+    if(star_count > 0) default_speed = m_config->tank_default_speed * 1.3;
+    else default_speed = m_config->tank_default_speed;
 }
@@ -3,6 +3,8 @@
 
 #include "tank.h"
 
+typedef unsigned PlayerInputs;
+
 /**
  * @brief Class corresponding to player tanks.
  */
@@ -39,18 +41,45 @@ public:
         SDL_Scancode fire;
     };
 
+    /**
+     * @brief Structure storing the player's state carried over between levels.
+     */
+    struct Progress
+    {
+        /**
+         * Number of lives.
+         */
+        int lives_count;
+        /**
+         * Points held by the player.
+         */
+        unsigned score;
+        /**
+         * Number of held stars.
+         */
+        int star_count;
+        /**
+         * Maximum number of bullets the player can fire.
+         */
+        unsigned bullet_max_size;
+    };
+
     /**
      * Creating a player in one of the player starting positions.
-     * @see AppConfig::player_starting_point
+     * @param engine - context of the game the player belongs to
+     * @param config - rules of the game the player belongs to
+     * @see GameConfig::player_starting_point
      */
-    Player();
+    Player(Engine* engine, const GameConfig* config);
     /**
      * Creating a player tank
+     * @param engine - context of the game the player belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param type - player type
+     * @param config - rules of the game the player belongs to
      */
-    Player(double x, double y, SpriteType type);
+    Player(Engine* engine, double x, double y, SpriteType type, const GameConfig* config);
 
 
     /**
@@ -73,6 +102,31 @@ public:
      */
     Bullet* fire();
 
+    /**
+     * @return lives, points and upgrades of the player
+     */
+    Progress getProgress() const;
+    /**
+     * Restoring lives, points and upgrades of the player, e.g. at the start of a replayed level.
+     * @param progress - state returned earlier by @a getProgress
+     */
+    void setProgress(const Progress& progress);
+    /**
+     * Appending the state of the player: the tank, points, upgrades and controls.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState. The keys are chosen according to the restored player type.
+     * @param reader - buffer of the saved game
+     */
+    void loadState(SnapshotReader& reader);
+    /**
+     * The function reads the state of the keys assigned to the player.
+     * @return combination of @a PlayerInputFlag values for pressed keys
+     */
+    PlayerInputs readKeyboard() const;
+
     /**
      * The function changes the number of stars currently held. With a non-zero number of stars, the default speed of the tank is increased,
      * and for a number of stars greater than 1 and for each positive @a c, the maximum number of bullets is increased.
@@ -88,6 +142,14 @@ public:
      * Points currently held by the player.
      */
     unsigned score;
+    /**
+     * Controls used in the last call of @a update; combination of @a PlayerInputFlag values.
+     */
+    PlayerInputs input;
+    /**
+     * If @a true, the tank is steered by the value of @a input set from outside (bot, replay) instead of the keyboard.
+     */
+    bool external_input;
 
 private:
     /**
@@ -2,35 +2,49 @@
 #include "../appconfig.h"
 #include <algorithm>
 
-Tank::Tank()
-    : Object(AppConfig::enemy_starting_point.at(0).x, AppConfig::enemy_starting_point.at(0).y, ST_TANK_A)
+Tank::Tank(Engine* engine, const GameConfig* config)
+    : Object(engine, config->enemy_starting_point.at(0).x, config->enemy_starting_point.at(0).y, ST_TANK_A)
 {
+    m_config = config;
     direction = D_UP;
+    new_direction = D_UP;
+    stop = false;
+    m_flags = 0;
+    lives_count = 1;
+    m_bullet_max_size = 1;
     m_slip_time = 0;
-    default_speed = AppConfig::tank_default_speed;
+    default_speed = m_config->tank_default_speed;
     speed = 0.0;
     m_shield = nullptr;
     m_boat = nullptr;
+    m_bullet_pool = nullptr;
     m_shield_time = 0;
     m_frozen_time = 0;
 }
 
-Tank::Tank(double x, double y, SpriteType type)
-    : Object(x, y, type)
+Tank::Tank(Engine* engine, double x, double y, SpriteType type, const GameConfig* config)
+    : Object(engine, x, y, type)
 {
+    m_config = config;
     direction = D_UP;
+    new_direction = D_UP;
+    stop = false;
+    m_flags = 0;
+    lives_count = 1;
+    m_bullet_max_size = 1;
     m_slip_time = 0;
-    default_speed = AppConfig::tank_default_speed;
+    default_speed = m_config->tank_default_speed;
     speed = 0.0;
     m_shield = nullptr;
     m_boat = nullptr;
+    m_bullet_pool = nullptr;
     m_shield_time = 0;
     m_frozen_time = 0;
 }
 
 Tank::~Tank()
 {
-    for(auto bullet : bullets) delete bullet;
+    for(auto bullet : bullets) deleteBullet(bullet);
     bullets.clear();
 
     if(m_shield != nullptr)
@@ -109,7 +123,7 @@ void Tank::update(Uint32 dt)
         m_shield->pos_x = pos_x;
         m_shield->pos_y = pos_y;
         m_shield->update(dt);
-        if(m_shield_time > AppConfig::tank_shield_time) clearFlag(TSF_SHIELD);
+        if(m_shield_time > m_config->tank_shield_time) clearFlag(TSF_SHIELD);
     }
     if(testFlag(TSF_BOAT) && m_boat != nullptr)
     {
@@ -120,7 +134,7 @@ void Tank::update(Uint32 dt)
     if(testFlag(TSF_FROZEN))
     {
         m_frozen_time += dt;
-        if(m_frozen_time > AppConfig::tank_frozen_time) clearFlag(TSF_FROZEN);
+        if(m_frozen_time > m_config->tank_frozen_time) clearFlag(TSF_FROZEN);
     }
 
     if(m_sprite->frames_count > 1 && (testFlag(TSF_LIFE) ? speed > 0 : true)) // stop animation if the tank is not trying to move
@@ -135,7 +149,7 @@ void Tank::update(Uint32 dt)
                 if(m_sprite->loop) m_current_frame = 0;
                 else if(testFlag(TSF_CREATE))
                 {
-                    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(type);
+                    m_sprite = m_engine->getSpriteConfig()->getSpriteData(type);
                     clearFlag(TSF_CREATE);
                     setFlag(TSF_LIFE);
                     m_current_frame = 0;
@@ -152,7 +166,7 @@ void Tank::update(Uint32 dt)
 
     // missile handling
     for(auto bullet : bullets) bullet->update(dt);
-    bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [](Bullet*b){if(b->to_erase) {delete b; return true;} return false;}), bullets.end());
+    bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [this](Bullet*b){if(b->to_erase) {deleteBullet(b); return true;} return false;}), bullets.end());
 }
 
 Bullet* Tank::fire()
@@ -161,7 +175,7 @@ Bullet* Tank::fire()
     if(bullets.size() < m_bullet_max_size)
     {
         //we give the initial any position because we do not know the dimensions of the projectile
-        Bullet* bullet = new Bullet(pos_x, pos_y);
+        Bullet* bullet = createBullet(pos_x, pos_y);
         bullets.push_back(bullet);
 
         Direction tmp_d = (testFlag(TSF_ON_ICE) ? new_direction : direction);
@@ -187,9 +201,9 @@ Bullet* Tank::fire()
 
         bullet->direction = tmp_d;
         if(type == ST_TANK_C)
-            bullet->speed = AppConfig::bullet_default_speed * 1.3;
+            bullet->speed = m_config->bullet_default_speed * 1.3;
         else
-            bullet->speed = AppConfig::bullet_default_speed;
+            bullet->speed = m_config->bullet_default_speed;
 
         bullet->update(0); //change of position district
         return bullet;
@@ -197,6 +211,37 @@ Bullet* Tank::fire()
     return nullptr;
 }
 
+void Tank::setConfig(const GameConfig* config)
+{
+    m_config = config;
+}
+
+void Tank::setBulletPool(BulletPool* pool)
+{
+    if(pool == m_bullet_pool) return;
+    for(auto bullet : bullets) deleteBullet(bullet);
+    bullets.clear();
+    m_bullet_pool = pool;
+}
+
+Bullet* Tank::createBullet(double x, double y)
+{
+    Bullet* bullet = nullptr;
+    if(m_bullet_pool != nullptr)
+    {
+        bullet = m_bullet_pool->acquire(x, y);
+        if(bullet == nullptr) m_bullet_pool->countOverflow();
+    }
+    if(bullet == nullptr) bullet = new Bullet(m_engine, x, y);
+    return bullet;
+}
+
+void Tank::deleteBullet(Bullet* bullet)
+{
+    if(m_bullet_pool != nullptr && m_bullet_pool->owns(bullet)) m_bullet_pool->release(bullet);
+    else delete bullet;
+}
+
 SDL_Rect Tank::nextCollisionRect(Uint32 dt)
 {
     if(speed == 0) return collision_rect;
@@ -236,7 +281,7 @@ void Tank::setDirection(Direction d)
         new_direction = d;
         if(speed == 0.0 || m_slip_time == 0.0) direction = d;
         if((m_slip_time != 0 && direction == new_direction) || m_slip_time == 0)
-            m_slip_time = AppConfig::slip_time;
+            m_slip_time = m_config->slip_time;
     }
     else
         direction = d;
@@ -297,7 +342,7 @@ void Tank::destroy()
     direction = D_UP;
     speed = 0;
     m_slip_time = 0;
-    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_DESTROY_TANK);
+    m_sprite = m_engine->getSpriteConfig()->getSpriteData(ST_DESTROY_TANK);
 
     collision_rect.x = 0;
     collision_rect.y = 0;
@@ -317,12 +362,12 @@ void Tank::setFlag(TankStateFlag flag)
 
     if(flag == TSF_SHIELD)
     {
-        if(m_shield == nullptr) m_shield = new Object(pos_x, pos_y, ST_SHIELD);
+        if(m_shield == nullptr) m_shield = new Object(m_engine, pos_x, pos_y, ST_SHIELD);
          m_shield_time = 0;
     }
     if(flag == TSF_BOAT)
     {
-         if(m_boat == nullptr) m_boat = new Object(pos_x, pos_y, type == ST_PLAYER_1 ? ST_BOAT_P1 : ST_BOAT_P2);
+         if(m_boat == nullptr) m_boat = new Object(m_engine, pos_x, pos_y, type == ST_PLAYER_1 ? ST_BOAT_P1 : ST_BOAT_P2);
     }
     if(flag == TSF_FROZEN)
     {
@@ -358,7 +403,7 @@ bool Tank::testFlag(TankStateFlag flag)
 
 void Tank::respawn()
 {
-    m_sprite = Engine::getEngine().getSpriteConfig()->getSpriteData(ST_CREATE);
+    m_sprite = m_engine->getSpriteConfig()->getSpriteData(ST_CREATE);
     speed = 0.0;
     stop = false;
     m_slip_time = 0;
@@ -375,3 +420,78 @@ void Tank::respawn()
     collision_rect.h = 0;
     collision_rect.w = 0;
 }
+
+void Tank::saveState(Snapshot& snapshot) const
+{
+    Object::saveState(snapshot);
+    snapshot.write(default_speed);
+    snapshot.write(speed);
+    snapshot.write(stop);
+    snapshot.write(direction);
+    snapshot.write(lives_count);
+    snapshot.write(m_flags);
+    snapshot.write(m_slip_time);
+    snapshot.write(new_direction);
+    snapshot.write(m_bullet_max_size);
+    snapshot.write(m_shield_time);
+    snapshot.write(m_frozen_time);
+
+    snapshot.write(m_shield != nullptr);
+    if(m_shield != nullptr) m_shield->saveState(snapshot);
+    snapshot.write(m_boat != nullptr);
+    if(m_boat != nullptr) m_boat->saveState(snapshot);
+
+    snapshot.write(static_cast<Uint32>(bullets.size()));
+    for(auto bullet : bullets) bullet->saveState(snapshot);
+}
+
+void Tank::loadState(SnapshotReader& reader)
+{
+    Object::loadState(reader);
+    reader.read(default_speed);
+    reader.read(speed);
+    reader.read(stop);
+    reader.read(direction);
+    reader.read(lives_count);
+    reader.read(m_flags);
+    reader.read(m_slip_time);
+    reader.read(new_direction);
+    reader.read(m_bullet_max_size);
+    reader.read(m_shield_time);
+    reader.read(m_frozen_time);
+
+    bool has_object = false;
+    reader.read(has_object);
+    if(has_object)
+    {
+        if(m_shield == nullptr) m_shield = new Object(m_engine, pos_x, pos_y, ST_SHIELD);
+        m_shield->loadState(reader);
+    }
+    else if(m_shield != nullptr)
+    {
+        delete m_shield;
+        m_shield = nullptr;
+    }
+    has_object = false;
+    reader.read(has_object);
+    if(has_object)
+    {
+        if(m_boat == nullptr) m_boat = new Object(m_engine, pos_x, pos_y, type == ST_PLAYER_1 ? ST_BOAT_P1 : ST_BOAT_P2);
+        m_boat->loadState(reader);
+    }
+    else if(m_boat != nullptr)
+    {
+        delete m_boat;
+        m_boat = nullptr;
+    }
+
+    Uint32 bullets_count = 0;
+    reader.read(bullets_count);
+    while(bullets.size() > bullets_count)
+    {
+        deleteBullet(bullets.back());
+        bullets.pop_back();
+    }
+    while(bullets.size() < bullets_count) bullets.push_back(createBullet(0, 0));
+    for(auto bullet : bullets) bullet->loadState(reader);
+}
@@ -3,7 +3,9 @@
 
 #include "object.h"
 #include "bullet.h"
+#include "bulletpool.h"
 #include "../type.h"
+#include "../gameconfig.h"
 
 #include <vector>
 
@@ -18,16 +20,20 @@ class Tank : public Object
 public:
     /**
      * Creating a tank at the first of the enemy starting positions.
-     * @see AppConfig::enemy_starting_point
+     * @param engine - context of the game the tank belongs to
+     * @param config - rules of the game the tank belongs to
+     * @see GameConfig::enemy_starting_point
      */
-    Tank();
+    Tank(Engine* engine, const GameConfig* config);
     /**
      * Creating a tank
+     * @param engine - context of the game the tank belongs to
      * @param x - initial horizontal position
      * @param y - initial vertical position
      * @param type - type of tank
+     * @param config - rules of the game the tank belongs to
      */
-    Tank(double x, double y, SpriteType type);
+    Tank(Engine* engine, double x, double y, SpriteType type, const GameConfig* config);
     virtual ~Tank();
 
     /**
@@ -46,6 +52,17 @@ public:
      * @return pointer to the created bullet, if no bullet was created returns @a nullptr
      */
     virtual Bullet* fire();
+    /**
+     * Setting the rules of the game the tank belongs to, used when a player goes to the next level.
+     * @param config - configuration that has to exist as long as the tank uses it
+     */
+    void setConfig(const GameConfig* config);
+    /**
+     * Setting the pool from which new bullets are taken. Bullets of the tank that are still flying are removed.
+     * Without a pool every bullet is allocated separately.
+     * @param pool - bullets of the game or @a nullptr
+     */
+    void setBulletPool(BulletPool* pool);
     /**
      * The function returns the collision rectangle that would be in the next frame assuming the speed and direction as they are currently.
      * @param dt - predicted time for calculating the next frame
@@ -70,6 +87,16 @@ public:
      * The function is responsible for enabling the tank explosion animation.
      */
     virtual void destroy();
+    /**
+     * Appending the state of the tank with its shield, boat and all bullets.
+     * @param snapshot - buffer of the saved game
+     */
+    void saveState(Snapshot& snapshot) const;
+    /**
+     * Restoring the state written by @a saveState. Bullets, the shield and the boat are created or deleted as needed.
+     * @param reader - buffer of the saved game
+     */
+    void loadState(SnapshotReader& reader);
     /**
      * Setting the selected flag.
      * @param flag
@@ -130,6 +157,27 @@ protected:
      */
     unsigned m_bullet_max_size;
 
+    /**
+     * Creating a bullet taken from @a m_bullet_pool, or allocated separately if there is no pool or it is full.
+     * @param x - initial horizontal position
+     * @param y - initial vertical position
+     * @return new bullet
+     */
+    Bullet* createBullet(double x, double y);
+    /**
+     * Returning the bullet to its pool or deleting it if it was allocated separately.
+     * @param bullet - bullet created by @a createBullet
+     */
+    void deleteBullet(Bullet* bullet);
+
+    /**
+     * Rules of the game the tank belongs to: speeds and timers.
+     */
+    const GameConfig* m_config;
+    /**
+     * Pool of bullets of the game the tank belongs to, @a nullptr if bullets are allocated separately.
+     */
+    BulletPool* m_bullet_pool;
     /**
      * Pointer to the tank's shield. If the tank does not have a shield, the variable is nullptr;
      */
@@ -0,0 +1,72 @@
+#include "bot.h"
+#include "../app_state/game.h"
+#include <cstdlib>
+
+Bot::Bot(BotType type, Uint64 seed)
+    : m_random(seed)
+{
+    m_type = type;
+    m_input = 0;
+    m_keep_time = 0;
+    m_last_position = {-1, -1};
+    m_stuck_time = 0;
+}
+
+PlayerInputs Bot::think(const Game* game, const Player* player, Uint32 dt)
+{
+    if(m_type == BT_IDLE) return 0;
+
+    SDL_Point position = {player->dest_rect.x, player->dest_rect.y};
+    if(position.x == m_last_position.x && position.y == m_last_position.y && (m_input & ~PI_FIRE)) m_stuck_time += dt;
+    else m_stuck_time = 0;
+    m_last_position = position;
+
+    m_keep_time -= dt;
+    if(m_type == BT_HUNTER && m_keep_time <= 0 && m_stuck_time < 300)
+    {
+        const Enemy* target = nullptr;
+        int min_metric = 0;
+        for(auto enemy : game->getEnemies())
+        {
+            if(enemy->to_erase || enemy->collision_rect.w == 0) continue; // exploding or being created
+            int metric = abs(enemy->dest_rect.x - position.x) + abs(enemy->dest_rect.y - position.y);
+            if(target == nullptr || metric < min_metric)
+            {
+                target = enemy;
+                min_metric = metric;
+            }
+        }
+
+        if(target != nullptr)
+        {
+            int dx = target->dest_rect.x - position.x;
+            int dy = target->dest_rect.y - position.y;
+
+            if(abs(dx) < 8) m_input = (dy < 0 ? PI_UP : PI_DOWN);
+            else if(abs(dy) < 8) m_input = (dx < 0 ? PI_LEFT : PI_RIGHT);
+            else if(abs(dx) < abs(dy)) m_input = (dx < 0 ? PI_LEFT : PI_RIGHT); // get in line on the shorter axis
+            else m_input = (dy < 0 ? PI_UP : PI_DOWN);
+            m_input |= PI_FIRE;
+            return m_input;
+        }
+    }
+
+    if(m_keep_time <= 0 || m_stuck_time >= 300)
+    {
+        m_keep_time = m_random.nextInt(800) + 200;
+        m_stuck_time = 0;
+        m_input = (m_random.nextInt(5) == 0 ? 0 : 1 << m_random.nextInt(4));
+    }
+
+    if(m_random.nextInt(3) == 0) return m_input | PI_FIRE;
+    return m_input & ~PI_FIRE;
+}
+
+bool Bot::parseType(const std::string& name, BotType& type)
+{
+    if(name == "idle") type = BT_IDLE;
+    else if(name == "random") type = BT_RANDOM;
+    else if(name == "hunter") type = BT_HUNTER;
+    else return false;
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "../objects/player.h"
+#include "../engine/random.h"
+#include <string>
+
+class Game;
+
+/**
+ * Behaviour of a bot steering a player's tank.
+ */
+enum BotType
+{
+    BT_IDLE,   // does not move or fire
+    BT_RANDOM, // drives in random directions and fires at random
+    BT_HUNTER  // chases the closest enemy and fires when in line with it
+};
+
+/**
+ * @brief
+ * Simple computer player used in headless and batch simulations instead of the keyboard.
+ */
+class Bot
+{
+public:
+    /**
+     * Creating a bot.
+     * @param type - behaviour of the bot
+     * @param seed - initial value of the bot's own random number generator; it is separate from the game generator
+     */
+    Bot(BotType type, Uint64 seed);
+
+    /**
+     * The function decides which controls the player's tank should use in the next simulation step.
+     * @param game - the game in which the bot plays
+     * @param player - tank steered by the bot
+     * @param dt - length of the simulation step in milliseconds
+     * @return combination of @a PlayerInputFlag values
+     */
+    PlayerInputs think(const Game* game, const Player* player, Uint32 dt);
+
+    /**
+     * Converting a bot name: "idle", "random" or "hunter".
+     * @param name - name of the behaviour
+     * @param type - converted behaviour
+     * @return @a false if the name is unknown
+     */
+    static bool parseType(const std::string& name, BotType& type);
+
+private:
+    /**
+     * Behaviour of the bot.
+     */
+    BotType m_type;
+    /**
+     * Random number generator of the bot.
+     */
+    Random m_random;
+    /**
+     * Controls chosen by the last decision.
+     */
+    PlayerInputs m_input;
+    /**
+     * Time left until the next decision in milliseconds.
+     */
+    Sint32 m_keep_time;
+    /**
+     * Position of the tank in the previous step, used to detect that the tank is stuck.
+     */
+    SDL_Point m_last_position;
+    /**
+     * Time for which the tank has not moved despite driving.
+     */
+    Uint32 m_stuck_time;
+};
+
+#endif // BOT_H
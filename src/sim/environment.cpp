@@ -0,0 +1,234 @@
+#include "environment.h"
+#include "../app_state/game.h"
+#include "../appconfig.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Reward for a killed enemy.
+ */
+static const float kill_reward = 1.0f;
+/**
+ * Reward for a life lost by a player.
+ */
+static const float life_reward = -1.0f;
+/**
+ * Reward for losing the game.
+ */
+static const float lost_reward = -5.0f;
+
+const unsigned Environment::player_features;
+const unsigned Environment::enemy_features;
+const unsigned Environment::enemy_slots;
+const unsigned Environment::observation_size;
+
+Environment::Environment(unsigned games_count, int players_count, unsigned threads_count, GameConfigPtr config)
+    : m_pool(threads_count)
+{
+    m_engine.initModules(false);
+    m_config = config;
+    m_slots.resize(games_count);
+    m_players_count = players_count;
+    m_level = 1;
+    m_dt = AppConfig::sim_tick_time;
+    m_max_ticks = 0;
+    m_part_function = nullptr;
+    m_actions = nullptr;
+    m_observations = nullptr;
+    m_rewards = nullptr;
+    m_done = nullptr;
+    m_tensors = nullptr;
+}
+
+Environment::~Environment()
+{
+    m_pool.wait();
+}
+
+bool Environment::reset(Uint64 seed, int level, float* observations)
+{
+    m_level = level;
+    for(unsigned i = 0; i < m_slots.size(); i++) m_slots[i].seed = seed + i;
+    m_observations = observations;
+    forEachPart(&Environment::resetGames);
+    return tensorsWritten();
+}
+
+bool Environment::step(const PlayerInputs* actions, float* observations, float* rewards, Uint8* done)
+{
+    m_actions = actions;
+    m_observations = observations;
+    m_rewards = rewards;
+    m_done = done;
+    forEachPart(&Environment::stepGames);
+    return tensorsWritten();
+}
+
+void Environment::setEpisodeLimit(unsigned long ticks)
+{
+    m_max_ticks = ticks;
+}
+
+void Environment::setTensorBuffer(Uint8* tensors)
+{
+    m_tensors = tensors;
+    for(auto& slot : m_slots) slot.encoder.reset();
+}
+
+size_t Environment::getTensorSize()
+{
+    return (size_t)TC_COUNT * (AppConfig::map_rect.h / AppConfig::tile_rect.h) * (AppConfig::map_rect.w / AppConfig::tile_rect.w);
+}
+
+unsigned Environment::size() const
+{
+    return m_slots.size();
+}
+
+int Environment::getPlayersCount() const
+{
+    return m_players_count;
+}
+
+const Game* Environment::getGame(unsigned index) const
+{
+    return m_slots[index].game.get();
+}
+
+void Environment::startEpisode(unsigned index)
+{
+    Slot& slot = m_slots[index];
+    slot.game.reset(new Game(&m_engine, m_players_count, slot.seed, m_level, m_config));
+    slot.encoder.reset();
+    // controls do not matter during the start screen
+    while(slot.game->isWaiting() && !slot.game->finished())
+        slot.game->update(m_dt);
+    slot.enemy_to_kill = slot.game->getEnemyToKill();
+    slot.lives = livesCount(*slot.game);
+    slot.ticks = 0;
+}
+
+void Environment::resetGames(unsigned first, unsigned last)
+{
+    for(unsigned i = first; i < last; i++)
+    {
+        startEpisode(i);
+        observe(i);
+    }
+}
+
+void Environment::stepGames(unsigned first, unsigned last)
+{
+    for(unsigned i = first; i < last; i++)
+    {
+        Slot& slot = m_slots[i];
+        Game& game = *slot.game;
+        for(int p = 0; p < m_players_count; p++)
+            game.setPlayerInput(p, m_actions[i * m_players_count + p]);
+        game.update(m_dt);
+        slot.ticks++;
+
+        int enemy_to_kill = game.getEnemyToKill();
+        int lives = livesCount(game);
+        float reward = (slot.enemy_to_kill - enemy_to_kill) * kill_reward;
+        if(lives < slot.lives) reward += (slot.lives - lives) * life_reward;
+        slot.enemy_to_kill = enemy_to_kill;
+        slot.lives = lives;
+
+        // the level is won when the last enemy is killed, the wait for the next level is not played
+        bool won = (enemy_to_kill <= 0 && game.getEnemies().empty());
+        bool done = game.finished() || game.isGameOver() || won || (m_max_ticks != 0 && slot.ticks >= m_max_ticks);
+        if(game.isGameOver()) reward += lost_reward;
+        m_rewards[i] = reward;
+        m_done[i] = done;
+
+        if(done)
+        {
+            slot.seed += m_slots.size();
+            startEpisode(i);
+        }
+        observe(i);
+    }
+}
+
+void Environment::observe(unsigned index)
+{
+    const Game& game = *m_slots[index].game;
+    float* observation = m_observations + index * observation_size;
+    const float width = AppConfig::map_rect.w, height = AppConfig::map_rect.h;
+
+    for(unsigned i = 0; i < observation_size; i++) observation[i] = 0.0f;
+    for(auto player : game.getPlayers())
+    {
+        float* features = observation + (player->type == ST_PLAYER_1 ? 0 : player_features);
+        features[0] = 1.0f;
+        features[1] = player->pos_x / width;
+        features[2] = player->pos_y / height;
+        features[3] = player->direction / 3.0f;
+        features[4] = player->lives_count / 10.0f;
+        features[5] = player->getProgress().star_count / 3.0f;
+    }
+
+    float* eagle = observation + 2 * player_features;
+    eagle[0] = (game.getEagle()->type == ST_EAGLE ? 1.0f : 0.0f);
+    eagle[1] = (float)game.getEnemyToKill() / game.getConfig().enemy_start_count;
+
+    float* features = eagle + 2;
+    unsigned count = 0;
+    for(auto enemy : game.getEnemies())
+    {
+        if(count++ == enemy_slots) break;
+        features[0] = 1.0f;
+        features[1] = enemy->pos_x / width;
+        features[2] = enemy->pos_y / height;
+        features[3] = enemy->direction / 3.0f;
+        features[4] = enemy->lives_count / 4.0f;
+        features += enemy_features;
+    }
+
+    if(m_tensors == nullptr) return;
+    Slot& slot = m_slots[index];
+    Uint8* tensor = m_tensors + index * getTensorSize();
+    slot.encoded = (TensorEncoder::size(game) == getTensorSize());
+    if(slot.encoded) slot.encoder.encode(game, tensor);
+    else
+    {
+        // an array of another map cannot be written, the old one must not look like a current one
+        memset(tensor, 0, getTensorSize());
+        slot.encoder.reset();
+    }
+}
+
+bool Environment::tensorsWritten() const
+{
+    if(m_tensors == nullptr) return true;
+    for(auto& slot : m_slots)
+        if(!slot.encoded) return false;
+    return true;
+}
+
+void Environment::forEachPart(void (Environment::*function)(unsigned, unsigned))
+{
+    unsigned parts = std::min<unsigned>(m_pool.size(), m_slots.size());
+    if(parts <= 1)
+    {
+        (this->*function)(0, m_slots.size());
+        return;
+    }
+
+    // the task captures this and two unsigned numbers, 16 bytes, which std::function of common standard libraries keeps without allocating
+    m_part_function = function;
+    for(unsigned part = 0; part < parts; part++)
+        m_pool.submit([this, part, parts]{
+            unsigned first = m_slots.size() * part / parts, last = m_slots.size() * (part + 1) / parts;
+            (this->*m_part_function)(first, last);
+        });
+    m_pool.wait();
+}
+
+int Environment::livesCount(const Game& game)
+{
+    int lives = 0;
+    for(auto player : game.getPlayers()) lives += player->lives_count;
+    return lives;
+}
@@ -0,0 +1,233 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include "../objects/player.h"
+#include "threadpool.h"
+#include "tensorencoder.h"
+#include "../gameconfig.h"
+#include "../engine/engine.h"
+#include <memory>
+#include <vector>
+
+class Game;
+
+/**
+ * @brief
+ * Environment for training bots in the style of a Gym vector environment: many games played in lock-step.
+ * @a reset starts a level in every game, @a step gives the controls to all players, makes one simulation step of every game
+ * and writes observations, rewards and end flags of all games into buffers owned by the caller.
+ * Games are split between the workers of a thread pool in equal parts, so a step submits one task per worker and writes
+ * the results in place without allocating memory. A game whose episode ended starts again in the same step with the next seed,
+ * its observation is the first one of the new episode. Episodes start after the start screen of the level and end when
+ * the level is won or lost, or after the tick limit.
+ *
+ * Reward of a step: +1 for every killed enemy, -1 for every life lost by the players and -5 when the game is lost.
+ *
+ * Observation of one game, @a observation_size floats:
+ * @li both players, also in a one player game: present, x, y, direction, lives, stars
+ * @li the eagle: alive, enemies left to kill
+ * @li @a enemy_slots enemies in the order of appearance: present, x, y, direction, armour
+ *
+ * Positions are divided by the size of the map, directions by 3, lives by 10, stars by 3,
+ * enemies left to kill by their number at the start of the level and armour by 4.
+ * With @a setTensorBuffer every game is also encoded by its own @a TensorEncoder, which updates only the changes of the step.
+ * The environment has its own @a Engine context without a renderer, only read by the workers.
+ */
+class Environment
+{
+public:
+    /**
+     * Number of values describing one player.
+     */
+    static const unsigned player_features = 6;
+    /**
+     * Number of values describing one enemy.
+     */
+    static const unsigned enemy_features = 5;
+    /**
+     * Number of described enemies, the most that can be on the map at the same time with the default rules.
+     */
+    static const unsigned enemy_slots = 4;
+    /**
+     * Number of floats in the observation of one game.
+     */
+    static const unsigned observation_size = 2 * player_features + 2 + enemy_slots * enemy_features;
+
+    /**
+     * Creating the environment, games are created by @a reset.
+     * @param games_count - number of games played at the same time
+     * @param players_count - number of players 1 or 2 in every game
+     * @param threads_count - number of worker threads, 0 means all cores
+     * @param config - rules of all games
+     */
+    Environment(unsigned games_count, int players_count = 1, unsigned threads_count = 0, GameConfigPtr config = GameConfig::defaults());
+    ~Environment();
+
+    /**
+     * Starting a level in every game.
+     * @param seed - random seed of the first game, next games use following numbers
+     * @param level - number of the played level
+     * @param observations - buffer of @a size * @a observation_size floats, filled with the first observations
+     * @return @a false if the array of a game was not written, see @a setTensorBuffer
+     */
+    bool reset(Uint64 seed, int level, float* observations);
+    /**
+     * One simulation step of every game.
+     * @param actions - controls of the players, @a getPlayersCount values per game, combinations of @a PlayerInputFlag values
+     * @param observations - buffer of @a size * @a observation_size floats, filled with the observations after the step
+     * @param rewards - buffer of @a size floats, filled with the rewards of the step
+     * @param done - buffer of @a size values, set to 1 in games whose episode ended in the step, otherwise 0
+     * @return @a false if the array of a game was not written, see @a setTensorBuffer
+     */
+    bool step(const PlayerInputs* actions, float* observations, float* rewards, Uint8* done);
+
+    /**
+     * Setting the longest episode.
+     * @param ticks - number of steps after which an episode ends, 0 means no limit
+     */
+    void setEpisodeLimit(unsigned long ticks);
+    /**
+     * Setting the buffer for the arrays of @a TensorEncoder, written in every @a reset and @a step after the observations.
+     * The buffer has to stay the same between steps, because only the changes of every step are written into it.
+     * A game whose map is not of the size of @a getTensorSize, e.g. because its level could not be loaded, is not encoded:
+     * its array is filled with zeros and @a reset or @a step returns @a false.
+     * @param tensors - buffer of @a size * @a getTensorSize bytes, @a nullptr to stop encoding
+     */
+    void setTensorBuffer(Uint8* tensors);
+    /**
+     * @return number of bytes of the array of one game, for a map of the size of @a AppConfig::map_rect
+     */
+    static size_t getTensorSize();
+    /**
+     * @return number of games
+     */
+    unsigned size() const;
+    /**
+     * @return number of players in every game
+     */
+    int getPlayersCount() const;
+    /**
+     * @param index - index of the game
+     * @return current game, @a nullptr before @a reset
+     */
+    const Game* getGame(unsigned index) const;
+
+private:
+    /**
+     * @brief State of one game of the environment.
+     */
+    struct Slot
+    {
+        std::unique_ptr<Game> game;
+        /**
+         * Encoder of the game into @a m_tensors.
+         */
+        TensorEncoder encoder;
+        /**
+         * Random seed of the current episode.
+         */
+        Uint64 seed;
+        /**
+         * Number of enemies left to kill after the last step.
+         */
+        int enemy_to_kill;
+        /**
+         * Sum of lives of the players after the last step.
+         */
+        int lives;
+        /**
+         * Number of steps of the current episode.
+         */
+        unsigned long ticks;
+        /**
+         * Whether the map of the game has the size of the array in @a m_tensors.
+         */
+        bool encoded;
+    };
+
+    /**
+     * Creating the game of a new episode and playing its start screen.
+     * @param index - index of the game
+     */
+    void startEpisode(unsigned index);
+    /**
+     * Starting new episodes of a part of the games and writing their observations, executed by one worker.
+     * @param first - index of the first game
+     * @param last - index after the last game
+     */
+    void resetGames(unsigned first, unsigned last);
+    /**
+     * One step of a part of the games, executed by one worker.
+     * @param first - index of the first game
+     * @param last - index after the last game
+     */
+    void stepGames(unsigned first, unsigned last);
+    /**
+     * Writing the observation of a game and its array of @a TensorEncoder if it is enabled.
+     * @param index - index of the game
+     */
+    void observe(unsigned index);
+    /**
+     * @return @a false if the array of a game was not written in the last @a reset or @a step
+     */
+    bool tensorsWritten() const;
+    /**
+     * Running a function for all games split into one part per worker.
+     * @param function - member function called with the first game and the index after the last game of a part
+     */
+    void forEachPart(void (Environment::*function)(unsigned, unsigned));
+    /**
+     * @return sum of lives of the players of a game
+     */
+    static int livesCount(const Game& game);
+
+    /**
+     * Games of the environment.
+     */
+    std::vector<Slot> m_slots;
+    /**
+     * Context of all games, without the renderer.
+     */
+    Engine m_engine;
+    /**
+     * Workers playing the games.
+     */
+    ThreadPool m_pool;
+    /**
+     * Rules of all games.
+     */
+    GameConfigPtr m_config;
+    /**
+     * Number of players in every game.
+     */
+    int m_players_count;
+    /**
+     * Number of the played level.
+     */
+    int m_level;
+    /**
+     * Length of one simulation step in milliseconds.
+     */
+    Uint32 m_dt;
+    /**
+     * Longest episode in steps, 0 means no limit.
+     */
+    unsigned long m_max_ticks;
+    /**
+     * Function run by the workers in @a forEachPart.
+     */
+    void (Environment::*m_part_function)(unsigned, unsigned);
+    /**
+     * Buffers of the current call of @a reset or @a step, read by the workers.
+     */
+    const PlayerInputs* m_actions;
+    float* m_observations;
+    float* m_rewards;
+    Uint8* m_done;
+    /**
+     * Buffer of the arrays of @a TensorEncoder, @a nullptr if the games are not encoded.
+     */
+    Uint8* m_tensors;
+};
+
+#endif // ENVIRONMENT_H
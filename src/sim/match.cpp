@@ -0,0 +1,99 @@
+#include "match.h"
+#include "../app_state/game.h"
+#include "../appconfig.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * Filling the statistics of a finished or interrupted game.
+ */
+static void finishResult(Game& game, MatchResult& result, std::chrono::steady_clock::time_point start)
+{
+    if(game.isGameOver()) result.outcome = MO_LOST;
+    else if(game.finished()) result.outcome = MO_WON;
+    else result.outcome = MO_TIMEOUT;
+
+    result.score = game.getScore();
+    const int enemy_start_count = game.getConfig().enemy_start_count;
+    result.kills = enemy_start_count - game.getEnemyToKill();
+    if(result.kills < 0) result.kills = 0;
+    if(result.kills > enemy_start_count) result.kills = enemy_start_count;
+    result.checksum = game.checksum();
+    result.peak_bullets = game.getBulletPool().getPeakCount();
+    result.overflow_bullets = game.getBulletPool().getOverflowCount();
+
+    result.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+MatchConfig::MatchConfig()
+{
+    level = 1;
+    players_count = 1;
+    seed = 1;
+    bot = BT_IDLE;
+    dt = AppConfig::sim_tick_time;
+    max_ticks = 0;
+    time_scale = 0;
+    game_config = GameConfig::defaults();
+}
+
+MatchResult runMatch(const MatchConfig& config)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // every match has its own context without a renderer, so matches on different threads share only the read-only rules
+    Engine engine;
+    engine.initModules(false);
+    Game game(&engine, config.players_count, config.seed, config.level, config.game_config);
+    if(!config.record_path.empty()) game.startRecording(config.dt);
+    std::vector<Bot> bots;
+    for(int i = 0; i < 2; i++)
+        bots.push_back(Bot(config.bot, config.seed * 2 + i + 1));
+
+    MatchResult result;
+    result.ticks = 0;
+    Uint64 played_time = 0;
+    while(!game.finished() && (config.max_ticks == 0 || result.ticks < config.max_ticks))
+    {
+        for(auto player : game.getPlayers())
+        {
+            int index = (player->type == ST_PLAYER_1 ? 0 : 1);
+            game.setPlayerInput(index, bots[index].think(&game, player, config.dt));
+        }
+        game.update(config.dt);
+        result.ticks++;
+
+        // a slowed down match waits until the real time catches up with the played time divided by the scale,
+        // in fast forward the start screen and the end of the level are not slowed down
+        if(config.time_scale != 0 && (config.time_scale == 1 || !game.isWaiting()))
+        {
+            played_time += config.dt;
+            std::this_thread::sleep_until(start + std::chrono::microseconds(played_time * 1000 / config.time_scale));
+        }
+    }
+
+    if(!config.record_path.empty()) game.getReplay().save(config.record_path);
+
+    finishResult(game, result, start);
+    return result;
+}
+
+MatchResult runReplay(const Replay& replay, GameConfigPtr config)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Engine engine;
+    engine.initModules(false);
+    Game game(&engine, replay, config);
+    MatchResult result;
+    result.ticks = 0;
+    while(!game.finished() && result.ticks < replay.getTicksCount())
+    {
+        game.update(replay.getTickTime());
+        result.ticks++;
+    }
+
+    finishResult(game, result, start);
+    return result;
+}
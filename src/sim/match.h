@@ -0,0 +1,121 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include "bot.h"
+#include "replay.h"
+#include "../gameconfig.h"
+#include <string>
+
+/**
+ * Result of a simulated match.
+ */
+enum MatchOutcome
+{
+    MO_WON,    // all enemies on the level were killed
+    MO_LOST,   // the eagle was destroyed or all players lost their lives
+    MO_TIMEOUT // the tick limit was reached
+};
+
+/**
+ * @brief Parameters of one match simulated without a window.
+ */
+struct MatchConfig
+{
+    /**
+     * Default match: first level, one idle player, step length @a AppConfig::sim_tick_time, as fast as possible, rules of @a GameConfig::defaults.
+     */
+    MatchConfig();
+
+    /**
+     * Number of the played level.
+     */
+    int level;
+    /**
+     * Number of players 1 or 2.
+     */
+    int players_count;
+    /**
+     * Initial value of the game random number generator; bots derive their seeds from it.
+     */
+    Uint64 seed;
+    /**
+     * Behaviour of the bots steering all players.
+     */
+    BotType bot;
+    /**
+     * Length of one simulation step in milliseconds.
+     */
+    Uint32 dt;
+    /**
+     * Maximum number of simulation steps, 0 means no limit.
+     */
+    unsigned long max_ticks;
+    /**
+     * Path of the file the match is recorded to, empty if the match is not recorded.
+     */
+    std::string record_path;
+    /**
+     * Speed of the match compared to real time, e.g. 10 or 100; 0 plays it as fast as possible.
+     * In fast forward the start screen and the end of the level are played as fast as possible, at 1 they take their normal time.
+     */
+    unsigned time_scale;
+    /**
+     * Rules of the game. Matches with different rules can be played at the same time.
+     */
+    GameConfigPtr game_config;
+};
+
+/**
+ * @brief Statistics of one finished match.
+ */
+struct MatchResult
+{
+    MatchOutcome outcome;
+    /**
+     * Number of simulated steps.
+     */
+    unsigned long ticks;
+    /**
+     * Sum of points of all players.
+     */
+    unsigned score;
+    /**
+     * Number of killed enemies.
+     */
+    int kills;
+    /**
+     * Time of the simulation in seconds.
+     */
+    double wall_time;
+    /**
+     * Value of @a Game::checksum after the last step.
+     */
+    Uint64 checksum;
+    /**
+     * Highest number of bullets existing at the same time, see @a BulletPool::getPeakCount.
+     */
+    unsigned peak_bullets;
+    /**
+     * Number of bullets that did not fit in the bullet pool of the game.
+     */
+    unsigned overflow_bullets;
+};
+
+/**
+ * The function plays one level without a renderer, steering all players by bots. Every call creates its own @a Engine context
+ * without the renderer, so it can be called on many threads at the same time.
+ * @param config - parameters of the match
+ * @return statistics of the match
+ */
+MatchResult runMatch(const MatchConfig& config);
+
+/**
+ * The function plays a recorded level without a renderer as fast as possible, feeding the recorded controls to @a Game::update.
+ * The playback is exact if the returned checksum is equal to @a Replay::getChecksum.
+ * @param replay - recording of the level
+ * @param config - rules of the recorded game
+ * @return statistics of the played level
+ */
+MatchResult runReplay(const Replay& replay, GameConfigPtr config = GameConfig::defaults());
+
+#endif // MATCH_H
@@ -0,0 +1,204 @@
+#include "replay.h"
+
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+
+static const char replay_magic[4] = {'T', 'N', 'K', 'R'};
+static const Uint8 replay_version = 4;
+
+static void write(std::vector<Uint8>& data, Uint64 value, int bytes)
+{
+    for(int i = 0; i < bytes; i++)
+        data.push_back((value >> (8 * i)) & 0xFF);
+}
+
+static bool read(const std::vector<Uint8>& data, size_t& pos, Uint64& value, int bytes)
+{
+    if(pos + bytes > data.size()) return false;
+    value = 0;
+    for(int i = 0; i < bytes; i++)
+        value |= static_cast<Uint64>(data[pos + i]) << (8 * i);
+    pos += bytes;
+    return true;
+}
+
+Replay::Replay()
+{
+    m_seed = 0;
+    m_level = 1;
+    m_tick_time = 0;
+    m_ticks_count = 0;
+    m_checksum = 0;
+    m_play_run = 0;
+    m_play_step = 0;
+}
+
+void Replay::start(Uint64 seed, int level, Uint32 dt, const std::vector<Player::Progress>& players)
+{
+    m_seed = seed;
+    m_level = level;
+    m_tick_time = dt;
+    m_players = players;
+    m_runs.clear();
+    m_ticks_count = 0;
+    m_checksum = 0;
+    rewind();
+}
+
+void Replay::record(PlayerInputs player1, PlayerInputs player2)
+{
+    Uint16 inputs = (player1 & 0x1F) | ((player2 & 0x1F) << 5);
+    if(!m_runs.empty() && m_runs.back().inputs == inputs && m_runs.back().length < 0xFFFF)
+        m_runs.back().length++;
+    else
+    {
+        Run run;
+        run.inputs = inputs;
+        run.length = 1;
+        m_runs.push_back(run);
+    }
+    m_ticks_count++;
+}
+
+void Replay::finish(Uint64 checksum)
+{
+    m_checksum = checksum;
+}
+
+bool Replay::save(const std::string& path) const
+{
+    std::vector<Uint8> data;
+    data.insert(data.end(), replay_magic, replay_magic + 4);
+    write(data, replay_version, 1);
+    write(data, m_players.size(), 1);
+    write(data, m_level, 2);
+    write(data, m_tick_time, 2);
+    write(data, m_seed, 8);
+    for(auto progress : m_players)
+    {
+        write(data, progress.lives_count, 2);
+        write(data, progress.score, 4);
+        write(data, progress.star_count, 1);
+        write(data, progress.bullet_max_size, 1);
+    }
+    write(data, m_runs.size(), 4);
+    for(auto run : m_runs)
+    {
+        write(data, run.inputs, 2);
+        write(data, run.length, 2);
+    }
+    write(data, m_ticks_count, 4);
+    write(data, m_checksum, 8);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if(!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+bool Replay::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if(!file.is_open()) return false;
+    std::vector<Uint8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    size_t pos = 4;
+    Uint64 version, players_count, level, tick_time, runs_count, value;
+    if(data.size() < pos || !std::equal(replay_magic, replay_magic + 4, data.begin())) return false;
+    if(!read(data, pos, version, 1) || version != replay_version) return false;
+    if(!read(data, pos, players_count, 1) || !read(data, pos, level, 2) || !read(data, pos, tick_time, 2) || !read(data, pos, m_seed, 8)) return false;
+    if(players_count < 1 || players_count > 2) return false;
+    m_level = level;
+    m_tick_time = tick_time;
+
+    m_players.clear();
+    for(unsigned i = 0; i < players_count; i++)
+    {
+        Player::Progress progress;
+        if(!read(data, pos, value, 2)) return false;
+        progress.lives_count = static_cast<Sint16>(value);
+        if(!read(data, pos, value, 4)) return false;
+        progress.score = value;
+        if(!read(data, pos, value, 1)) return false;
+        progress.star_count = value;
+        if(!read(data, pos, value, 1)) return false;
+        progress.bullet_max_size = value;
+        m_players.push_back(progress);
+    }
+
+    if(!read(data, pos, runs_count, 4) || pos + runs_count * 4 > data.size()) return false;
+    m_runs.clear();
+    m_runs.reserve(runs_count);
+    for(unsigned i = 0; i < runs_count; i++)
+    {
+        Run run;
+        read(data, pos, value, 2);
+        run.inputs = value;
+        read(data, pos, value, 2);
+        run.length = value;
+        m_runs.push_back(run);
+    }
+    if(!read(data, pos, value, 4) || !read(data, pos, m_checksum, 8)) return false;
+    m_ticks_count = value;
+
+    rewind();
+    return true;
+}
+
+void Replay::rewind()
+{
+    m_play_run = 0;
+    m_play_step = 0;
+}
+
+bool Replay::next(PlayerInputs& player1, PlayerInputs& player2)
+{
+    while(m_play_run < m_runs.size() && m_play_step >= m_runs[m_play_run].length)
+    {
+        m_play_run++;
+        m_play_step = 0;
+    }
+    if(m_play_run >= m_runs.size()) return false;
+
+    Uint16 inputs = m_runs[m_play_run].inputs;
+    player1 = inputs & 0x1F;
+    player2 = (inputs >> 5) & 0x1F;
+    m_play_step++;
+    return true;
+}
+
+Uint64 Replay::getSeed() const
+{
+    return m_seed;
+}
+
+int Replay::getLevel() const
+{
+    return m_level;
+}
+
+Uint32 Replay::getTickTime() const
+{
+    return m_tick_time;
+}
+
+int Replay::getPlayersCount() const
+{
+    return m_players.size();
+}
+
+Player::Progress Replay::getProgress(int player_index) const
+{
+    return m_players.at(player_index);
+}
+
+unsigned long Replay::getTicksCount() const
+{
+    return m_ticks_count;
+}
+
+Uint64 Replay::getChecksum() const
+{
+    return m_checksum;
+}
@@ -0,0 +1,153 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "../objects/player.h"
+#include <SDL2/SDL_stdinc.h>
+#include <vector>
+#include <string>
+
+/**
+ * @brief Recording of one level: the random seed, the starting state of players and the controls of both players in every simulation step.
+ * The game is deterministic for a given seed, so feeding the recorded controls into @a Game::update reproduces the level exactly.
+ *
+ * Binary file layout (all numbers little-endian):
+ * @li header: "TNKR", version (1 byte), number of players (1 byte), level (2 bytes), step length in ms (2 bytes), seed (8 bytes)
+ * @li progress of every player: lives (2 bytes), points (4 bytes), stars (1 byte), maximum number of bullets (1 byte)
+ * @li number of runs (4 bytes) followed by the runs: controls of both players (2 bytes) and the number of steps they were held (2 bytes)
+ * @li number of steps (4 bytes) and @a Game::checksum after the last step (8 bytes)
+ */
+class Replay
+{
+public:
+    Replay();
+
+    /**
+     * Clearing the recording and storing the starting parameters of the level.
+     * @param seed - initial value of the random number generator of the game
+     * @param level - number of the recorded level
+     * @param dt - length of one simulation step in milliseconds
+     * @param players - progress of the players at the start of the level
+     */
+    void start(Uint64 seed, int level, Uint32 dt, const std::vector<Player::Progress>& players);
+    /**
+     * Appending the controls of one simulation step.
+     * @param player1 - controls of the first player
+     * @param player2 - controls of the second player
+     */
+    void record(PlayerInputs player1, PlayerInputs player2);
+    /**
+     * Storing the state of the game after the last step, used to verify the playback.
+     * @param checksum - value of @a Game::checksum
+     */
+    void finish(Uint64 checksum);
+    /**
+     * Writing the recording to a binary file.
+     * @param path - path to the file
+     * @return @a true if the file was written
+     */
+    bool save(const std::string& path) const;
+    /**
+     * Reading the recording from a binary file.
+     * @param path - path to the file
+     * @return @a false if the file does not exist or is not a valid replay
+     */
+    bool load(const std::string& path);
+
+    /**
+     * Moving the playback to the first step.
+     */
+    void rewind();
+    /**
+     * Reading the controls of the next step of the playback.
+     * @param player1 - controls of the first player
+     * @param player2 - controls of the second player
+     * @return @a false if all steps were played
+     */
+    bool next(PlayerInputs& player1, PlayerInputs& player2);
+
+    /**
+     * @return initial value of the random number generator of the game
+     */
+    Uint64 getSeed() const;
+    /**
+     * @return number of the recorded level
+     */
+    int getLevel() const;
+    /**
+     * @return length of one simulation step in milliseconds
+     */
+    Uint32 getTickTime() const;
+    /**
+     * @return number of players 1 or 2
+     */
+    int getPlayersCount() const;
+    /**
+     * @param player_index - 0 for the first player, 1 for the second
+     * @return progress of the player at the start of the level
+     */
+    Player::Progress getProgress(int player_index) const;
+    /**
+     * @return number of recorded steps
+     */
+    unsigned long getTicksCount() const;
+    /**
+     * @return value passed to @a finish, 0 if the recording was not finished
+     */
+    Uint64 getChecksum() const;
+
+private:
+    /**
+     * Controls of both players held for many subsequent steps.
+     */
+    struct Run
+    {
+        /**
+         * Controls of the first player in bits 0-4 and of the second player in bits 5-9.
+         */
+        Uint16 inputs;
+        /**
+         * Number of steps.
+         */
+        Uint16 length;
+    };
+
+    /**
+     * Initial value of the random number generator of the game.
+     */
+    Uint64 m_seed;
+    /**
+     * Number of the recorded level.
+     */
+    int m_level;
+    /**
+     * Length of one simulation step in milliseconds.
+     */
+    Uint32 m_tick_time;
+    /**
+     * Progress of the players at the start of the level.
+     */
+    std::vector<Player::Progress> m_players;
+    /**
+     * Recorded controls compressed by run-length encoding.
+     */
+    std::vector<Run> m_runs;
+    /**
+     * Number of recorded steps.
+     */
+    unsigned long m_ticks_count;
+    /**
+     * Checksum of the game after the last step.
+     */
+    Uint64 m_checksum;
+
+    /**
+     * Index of the run read by @a next.
+     */
+    unsigned m_play_run;
+    /**
+     * Number of steps already read from the current run.
+     */
+    unsigned m_play_step;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,127 @@
+#include "tensorencoder.h"
+#include "../app_state/game.h"
+#include "../appconfig.h"
+#include <cstring>
+
+TensorEncoder::TensorEncoder()
+{
+    reset();
+}
+
+size_t TensorEncoder::size(const Game& game)
+{
+    const Level& level = game.getLevel();
+    return (size_t)TC_COUNT * level.getRowsCount() * level.getColumnsCount();
+}
+
+void TensorEncoder::encode(const Game& game, Uint8* buffer)
+{
+    const Level& level = game.getLevel();
+    const int fields_count = level.getRowsCount() * level.getColumnsCount();
+
+    // the map: only the changed fields, or all of them if the changes are not known
+    bool full = (buffer != m_buffer || level.getRowsCount() != m_rows_count || level.getColumnsCount() != m_columns_count);
+    m_changes.clear();
+    if(!full && level.getTilesRevision() != m_tiles_revision)
+        full = !level.getTileChanges(m_tiles_revision, m_changes);
+    m_buffer = buffer;
+    m_rows_count = level.getRowsCount();
+    m_columns_count = level.getColumnsCount();
+    m_tiles_revision = level.getTilesRevision();
+
+    if(full)
+    {
+        memset(m_buffer, 0, size(game));
+        m_bush_cells.clear();
+        m_object_cells.clear();
+        m_bushes_count = 0;
+        for(int i = 0; i < fields_count; i++) encodeTile(level, i);
+    }
+    else
+    {
+        for(int index : m_changes) encodeTile(level, index);
+        for(unsigned cell : m_object_cells) m_buffer[cell] = 0;
+        m_object_cells.clear();
+    }
+
+    // bushes disappear only when they are shot, so they are written again only if their number changed
+    const std::vector<Object*>& bushes = game.getBushes();
+    if(full || bushes.size() != m_bushes_count)
+    {
+        for(unsigned cell : m_bush_cells) m_buffer[cell] = 0;
+        m_bush_cells.clear();
+        for(auto bush : bushes)
+        {
+            int index = fieldIndex(bush->collision_rect);
+            if(index < 0) continue;
+            unsigned cell = TC_BUSH * fields_count + index;
+            m_buffer[cell] = 1;
+            m_bush_cells.push_back(cell);
+        }
+        m_bushes_count = bushes.size();
+    }
+
+    for(auto player : game.getPlayers())
+    {
+        if(player->testFlag(TSF_DESTROYED)) continue;
+        TensorChannel channel = (player->type == ST_PLAYER_1 ? TC_PLAYER_1 : TC_PLAYER_2);
+        writeObject(channel, player->collision_rect, 1 + player->direction + 4 * player->getProgress().star_count);
+        for(auto bullet : player->bullets)
+            if(!bullet->collide) writeObject(TC_PLAYER_BULLET, bullet->collision_rect, 1 + bullet->direction + (bullet->increased_damage ? 4 : 0));
+    }
+    for(auto enemy : game.getEnemies())
+    {
+        if(!enemy->testFlag(TSF_DESTROYED))
+        {
+            int armour = (enemy->lives_count < 1 ? 1 : enemy->lives_count);
+            writeObject(TC_ENEMY, enemy->collision_rect, 1 + enemy->direction + 4 * (armour - 1));
+            writeObject(TC_ENEMY_TYPE, enemy->collision_rect, 1 + enemy->type - ST_TANK_A);
+        }
+        for(auto bullet : enemy->bullets)
+            if(!bullet->collide) writeObject(TC_ENEMY_BULLET, bullet->collision_rect, 1 + bullet->direction);
+    }
+    for(auto bonus : game.getBonuses())
+        if(!bonus->to_erase) writeObject(TC_BONUS, bonus->collision_rect, 1 + bonus->type - ST_BONUS_GRENADE);
+    const Eagle* eagle = game.getEagle();
+    if(eagle != nullptr) writeObject(TC_EAGLE, eagle->collision_rect, eagle->type == ST_EAGLE ? 1 : 2);
+}
+
+void TensorEncoder::reset()
+{
+    m_buffer = nullptr;
+    m_rows_count = 0;
+    m_columns_count = 0;
+    m_tiles_revision = 0;
+    m_bushes_count = 0;
+    m_changes.clear();
+    m_bush_cells.clear();
+    m_object_cells.clear();
+}
+
+void TensorEncoder::encodeTile(const Level& level, int index)
+{
+    const int fields_count = m_rows_count * m_columns_count;
+    const Tile& tile = level.at(index / m_columns_count, index % m_columns_count);
+    m_buffer[TC_BRICK * fields_count + index] = (tile.type == ST_BRICK_WALL ? tile.quarters : 0);
+    m_buffer[TC_STONE * fields_count + index] = (tile.type == ST_STONE_WALL);
+    m_buffer[TC_WATER * fields_count + index] = (tile.type == ST_WATER);
+    m_buffer[TC_ICE * fields_count + index] = (tile.type == ST_ICE);
+}
+
+int TensorEncoder::fieldIndex(const SDL_Rect& rect) const
+{
+    int x = rect.x + rect.w / 2, y = rect.y + rect.h / 2;
+    if(x < 0 || y < 0) return -1;
+    int row = y / AppConfig::tile_rect.h, column = x / AppConfig::tile_rect.w;
+    if(row >= m_rows_count || column >= m_columns_count) return -1;
+    return row * m_columns_count + column;
+}
+
+void TensorEncoder::writeObject(TensorChannel channel, const SDL_Rect& rect, Uint8 value)
+{
+    int index = fieldIndex(rect);
+    if(index < 0) return;
+    unsigned cell = channel * m_rows_count * m_columns_count + index;
+    m_buffer[cell] = value;
+    m_object_cells.push_back(cell);
+}
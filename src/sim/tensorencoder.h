@@ -0,0 +1,117 @@
+#ifndef TENSORENCODER_H
+#define TENSORENCODER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+class Game;
+class Level;
+
+/**
+ * Channels of the tensor written by @a TensorEncoder. Every channel has one byte per field of the map, 0 means nothing.
+ */
+enum TensorChannel
+{
+    TC_BRICK,          // standing quarters of a brick wall, mask of TileQuarter values 1-15
+    TC_STONE,          // 1 for a stone wall
+    TC_WATER,          // 1 for water
+    TC_ICE,            // 1 for ice
+    TC_BUSH,           // 1 for a bush
+    TC_PLAYER_1,       // tank of the first player: 1 + direction + 4 * stars
+    TC_PLAYER_2,       // tank of the second player: 1 + direction + 4 * stars
+    TC_ENEMY,          // enemy tank: 1 + direction + 4 * (armour - 1)
+    TC_ENEMY_TYPE,     // type of the enemy tank: 1 for A to 4 for D
+    TC_PLAYER_BULLET,  // bullet of a player: 1 + direction, 4 more for a bullet destroying stone walls
+    TC_ENEMY_BULLET,   // bullet of an enemy: 1 + direction
+    TC_BONUS,          // bonus: 1 for a grenade to 8 for a boat
+    TC_EAGLE,          // 1 for the eagle, 2 for the destroyed eagle
+    TC_COUNT
+};
+
+/**
+ * @brief
+ * Encoder of the state of a game into a dense array for training bots: @a TC_COUNT channels of the size of the map,
+ * channel after channel, row after row, one byte per field. Objects are placed in the field under the middle of their
+ * collision rectangle.
+ *
+ * The array belongs to the caller and keeps the last encoded state, so the next @a encode of the same game changes only
+ * what changed since then: fields of the map changed according to @a Level::getTileChanges, bushes when their number changes,
+ * and tanks, bullets, bonuses and the eagle are removed from the fields written last time and written again.
+ * The whole array is written only at the first call, after @a reset or when the changes of the map are not known.
+ */
+class TensorEncoder
+{
+public:
+    TensorEncoder();
+
+    /**
+     * @param game - encoded game
+     * @return number of bytes of the array of the game
+     */
+    static size_t size(const Game& game);
+    /**
+     * Writing the state of the game into the array.
+     * @param game - encoded game, the same as in the last call unless @a reset was called
+     * @param buffer - array of @a size bytes, the same as in the last call for an update of the changes
+     */
+    void encode(const Game& game, Uint8* buffer);
+    /**
+     * Forgetting the last encoded state, the next @a encode writes the whole array, e.g. for another game.
+     */
+    void reset();
+
+private:
+    /**
+     * Writing the channels of the map of one field.
+     * @param level - map of the game
+     * @param index - index of the field
+     */
+    void encodeTile(const Level& level, int index);
+    /**
+     * @param rect - collision rectangle of an object
+     * @return index of the field under the middle of the rectangle, -1 outside the map
+     */
+    int fieldIndex(const SDL_Rect& rect) const;
+    /**
+     * Writing an object that moves or disappears, it is removed in the next @a encode.
+     * @param channel - channel of the object
+     * @param rect - collision rectangle of the object
+     * @param value - written value
+     */
+    void writeObject(TensorChannel channel, const SDL_Rect& rect, Uint8 value);
+
+    /**
+     * Array of the last call of @a encode, @a nullptr if nothing was encoded since @a reset.
+     */
+    Uint8* m_buffer;
+    /**
+     * Number of rows of the encoded map.
+     */
+    int m_rows_count;
+    /**
+     * Number of columns of the encoded map.
+     */
+    int m_columns_count;
+    /**
+     * Value of @a Level::getTilesRevision at the last call of @a encode.
+     */
+    Uint32 m_tiles_revision;
+    /**
+     * Fields of the map changed since the last call of @a encode.
+     */
+    std::vector<int> m_changes;
+    /**
+     * Number of bushes at the last call of @a encode.
+     */
+    unsigned m_bushes_count;
+    /**
+     * Positions in the array of the written bushes.
+     */
+    std::vector<unsigned> m_bush_cells;
+    /**
+     * Positions in the array of the written tanks, bullets, bonuses and the eagle.
+     */
+    std::vector<unsigned> m_object_cells;
+};
+
+#endif // TENSORENCODER_H
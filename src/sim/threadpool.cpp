@@ -0,0 +1,103 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned threads_count)
+{
+    if(threads_count == 0) threads_count = std::thread::hardware_concurrency();
+    if(threads_count == 0) threads_count = 1;
+
+    m_queued = 0;
+    m_pending = 0;
+    m_next_queue = 0;
+    m_stop = false;
+
+    for(unsigned i = 0; i < threads_count; i++)
+        m_queues.push_back(std::unique_ptr<Queue>(new Queue));
+    for(unsigned i = 0; i < threads_count; i++)
+        m_threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_condition.notify_all();
+    for(auto& thread : m_threads) thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned index;
+    {
+        // counters go first, so a worker never finishes a task that is not counted yet
+        std::lock_guard<std::mutex> lock(m_mutex);
+        index = m_next_queue;
+        m_next_queue = (m_next_queue + 1) % m_queues.size();
+        m_queued++;
+        m_pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_work_condition.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this]{ return m_pending == 0; });
+}
+
+unsigned ThreadPool::size() const
+{
+    return m_threads.size();
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    while(true)
+    {
+        std::function<void()> task;
+        if(popTask(index, task))
+        {
+            task();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(--m_pending == 0) m_done_condition.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_work_condition.wait(lock, [this]{ return m_stop || m_queued > 0; });
+        if(m_stop && m_queued == 0) return;
+    }
+}
+
+bool ThreadPool::popTask(unsigned index, std::function<void()>& task)
+{
+    for(unsigned i = 0; i < m_queues.size(); i++)
+    {
+        Queue& queue = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tasks.empty()) continue;
+
+        if(i == 0) // own queue: newest task
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else // stealing: oldest task
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        std::lock_guard<std::mutex> counter_lock(m_mutex);
+        m_queued--;
+        return true;
+    }
+    return false;
+}
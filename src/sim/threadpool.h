@@ -0,0 +1,105 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ * Work-stealing thread pool. Every worker has its own queue of tasks; a worker takes tasks from the back of its own queue
+ * and, when the queue is empty, steals from the front of the queues of other workers.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Creating the worker threads.
+     * @param threads_count - number of workers, 0 means one worker per hardware thread
+     */
+    ThreadPool(unsigned threads_count = 0);
+    /**
+     * Finishing all submitted tasks and stopping the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * Adding a task; tasks are distributed to the worker queues in turn.
+     * @param task - function executed on one of the workers
+     */
+    void submit(std::function<void()> task);
+    /**
+     * Waiting until all submitted tasks are finished.
+     */
+    void wait();
+    /**
+     * @return number of worker threads
+     */
+    unsigned size() const;
+
+private:
+    /**
+     * @brief Queue of tasks belonging to one worker.
+     */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /**
+     * Main loop of a worker thread.
+     * @param index - number of the worker
+     */
+    void workerLoop(unsigned index);
+    /**
+     * Taking a task from the worker's own queue or stealing it from another queue.
+     * @param index - number of the worker
+     * @param task - taken task
+     * @return @a true if a task was taken
+     */
+    bool popTask(unsigned index, std::function<void()>& task);
+
+    /**
+     * Task queues, one per worker.
+     */
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    /**
+     * Worker threads.
+     */
+    std::vector<std::thread> m_threads;
+    /**
+     * Protects the counters and the stop flag.
+     */
+    std::mutex m_mutex;
+    /**
+     * Wakes up workers when new tasks appear.
+     */
+    std::condition_variable m_work_condition;
+    /**
+     * Wakes up @a wait when the last task is finished.
+     */
+    std::condition_variable m_done_condition;
+    /**
+     * Number of tasks waiting in the queues.
+     */
+    unsigned m_queued;
+    /**
+     * Number of submitted and not yet finished tasks.
+     */
+    unsigned m_pending;
+    /**
+     * Queue that gets the next submitted task.
+     */
+    unsigned m_next_queue;
+    /**
+     * Variable says whether the workers should end.
+     */
+    bool m_stop;
+};
+
+#endif // THREADPOOL_H
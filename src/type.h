@@ -60,6 +60,15 @@ enum TankStateFlag
     TSF_MENU = 1 << 9 // double speed of animation
 };
 
+enum PlayerInputFlag
+{
+    PI_UP = 1 << 0,
+    PI_DOWN = 1 << 1,
+    PI_LEFT = 1 << 2,
+    PI_RIGHT = 1 << 3,
+    PI_FIRE = 1 << 4
+};
+
 enum Direction
 {
     D_UP = 0,
@@ -0,0 +1,143 @@
+/**
+ * Batch match runner.
+ * The program plays every combination of the selected levels and seeds, one match per task on a work-stealing
+ * thread pool, and prints aggregated statistics together with throughput of the simulation.
+ *
+ * Usage: tanks-batch [--level A[-B]] [--seed A[-B]] [--ai NAME] [--players 1|2] [--threads N] [--ticks N] [--dt MS] [--levels PATH] [--config FILE] [--set NAME=VALUE]
+ */
+
+#include "sim/match.h"
+#include "sim/threadpool.h"
+#include "appconfig.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+static void printUsage(const char* name)
+{
+    std::cout << "Usage: " << name << " [options]" << std::endl
+              << "  --level A[-B]  range of played levels (default 1)" << std::endl
+              << "  --seed A[-B]   range of random seeds, every level is played with every seed (default 1-100)" << std::endl
+              << "  --ai NAME      bot steering the players: idle, random or hunter (default hunter)" << std::endl
+              << "  --players N    number of players 1 or 2 (default 1)" << std::endl
+              << "  --threads N    number of worker threads, 0 means all cores (default 0)" << std::endl
+              << "  --ticks N      tick limit of one match, 0 means one hour of game time (default 0)" << std::endl
+              << "  --dt MS        simulation step in milliseconds (default " << AppConfig::sim_tick_time << ")" << std::endl
+              << "  --levels PATH  directory with levels (default " << AppConfig::levels_path << ")" << std::endl
+              << "  --config FILE  rules of the game, see GameConfig" << std::endl
+              << "  --set NAME=VALUE  change one rule of the game, e.g. enemy_max_count_on_map=8" << std::endl;
+}
+
+static bool parseRange(const char* text, Uint64& first, Uint64& last)
+{
+    char* end;
+    first = strtoull(text, &end, 10);
+    if(end == text) return false;
+    last = first;
+    if(*end == '-') last = strtoull(end + 1, &end, 10);
+    return *end == '\0' && last >= first;
+}
+
+int main( int argc, char* args[] )
+{
+    MatchConfig config;
+    config.bot = BT_HUNTER;
+    Uint64 first_level = 1, last_level = 1;
+    Uint64 first_seed = 1, last_seed = 100;
+    unsigned threads_count = 0;
+    GameConfig game_config;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--level") && has_value && parseRange(args[i + 1], first_level, last_level)) i++;
+        else if(!strcmp(args[i], "--seed") && has_value && parseRange(args[i + 1], first_seed, last_seed)) i++;
+        else if(!strcmp(args[i], "--ai") && has_value && Bot::parseType(args[i + 1], config.bot)) i++;
+        else if(!strcmp(args[i], "--players") && has_value) config.players_count = atoi(args[++i]);
+        else if(!strcmp(args[i], "--threads") && has_value) threads_count = atoi(args[++i]);
+        else if(!strcmp(args[i], "--ticks") && has_value) config.max_ticks = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--dt") && has_value) config.dt = atoi(args[++i]);
+        else if(!strcmp(args[i], "--levels") && has_value) AppConfig::levels_path = std::string(args[++i]) + "/";
+        else if(!strcmp(args[i], "--config") && has_value && game_config.load(args[i + 1])) i++;
+        else if(!strcmp(args[i], "--set") && has_value && game_config.set(args[i + 1])) i++;
+        else
+        {
+            printUsage(args[0]);
+            return 1;
+        }
+    }
+    if(config.dt == 0)
+    {
+        std::cerr << "dt has to be at least 1 ms" << std::endl;
+        return 1;
+    }
+    if(config.max_ticks == 0) config.max_ticks = 60 * 60 * 1000 / config.dt;
+    // one configuration read by all workers
+    config.game_config = std::make_shared<const GameConfig>(game_config);
+
+    std::vector<MatchConfig> configs;
+    for(Uint64 level = first_level; level <= last_level; level++)
+        for(Uint64 seed = first_seed; seed <= last_seed; seed++)
+        {
+            config.level = level;
+            config.seed = seed;
+            configs.push_back(config);
+        }
+    std::vector<MatchResult> results(configs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned workers;
+    {
+        ThreadPool pool(threads_count);
+        workers = pool.size();
+        for(unsigned i = 0; i < configs.size(); i++)
+            pool.submit([&configs, &results, i]{ results[i] = runMatch(configs[i]); });
+        pool.wait();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // aggregated statistics, one line per level and a summary
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "level  matches  won  lost  timeout  avg score  avg kills" << std::endl;
+    int outcomes[3] = {0, 0, 0};
+    unsigned long total_ticks = 0;
+    double total_score = 0, total_kills = 0, match_time = 0, min_time = 0, max_time = 0;
+    for(unsigned i = 0; i < results.size(); )
+    {
+        int level = configs[i].level;
+        int level_outcomes[3] = {0, 0, 0};
+        double score = 0, kills = 0;
+        unsigned count = 0;
+        for(; i < results.size() && configs[i].level == level; i++, count++)
+        {
+            const MatchResult& r = results[i];
+            level_outcomes[r.outcome]++;
+            outcomes[r.outcome]++;
+            score += r.score;
+            kills += r.kills;
+            total_ticks += r.ticks;
+            match_time += r.wall_time;
+            if(min_time == 0 || r.wall_time < min_time) min_time = r.wall_time;
+            if(r.wall_time > max_time) max_time = r.wall_time;
+        }
+        total_score += score;
+        total_kills += kills;
+        std::cout << std::setw(5) << level << std::setw(9) << count << std::setw(5) << level_outcomes[MO_WON]
+                  << std::setw(6) << level_outcomes[MO_LOST] << std::setw(9) << level_outcomes[MO_TIMEOUT]
+                  << std::setw(11) << score / count << std::setw(11) << kills / count << std::endl;
+    }
+
+    double matches = results.size();
+    std::cout << std::endl
+              << "matches: " << results.size() << " (won " << outcomes[MO_WON] << ", lost " << outcomes[MO_LOST] << ", timeout " << outcomes[MO_TIMEOUT] << ")" << std::endl
+              << "avg score: " << total_score / matches << ", avg kills: " << total_kills / matches << std::endl
+              << "threads: " << workers << ", wall time: " << wall << " s" << std::endl
+              << "matches/s: " << matches / wall << ", ticks/s: " << total_ticks / wall << std::endl
+              << "per-match wall time: avg " << match_time / matches * 1000 << " ms, min " << min_time * 1000
+              << " ms, max " << max_time * 1000 << " ms" << std::endl;
+    return 0;
+}
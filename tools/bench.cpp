@@ -0,0 +1,847 @@
+/**
+ * Micro-benchmarks of the simulation.
+ * Every benchmark is selected by its name and prints its own measurements.
+ *
+ * Usage: tanks-bench NAME [options]
+ *  snapshot - cost and size of Game::saveSnapshot and Game::restoreSnapshot, checks that a restored game continues identically
+ *  broadphase - SpatialHash against testing all pairs for 10, 100 and 1000 entities, half tanks and half bullets
+ *  bullets - taking bullets from BulletPool against allocating every bullet with new
+ *  rects - testing one rectangle against many with RectBatch against calling intersectRect for every pair
+ *  entities - updating tanks and bullets stored in a prototype EntityStore against updating Tank and Bullet objects
+ *  flowfield - repairing a FlowField after single changed fields against building it again, on maps from 26x26 to 1024x1024
+ *  env - steps per second of Environment with 1, 64 and 1024 games played in lock-step
+ *  tensor - encodes per second of TensorEncoder updating the changes of every step against encoding the whole game
+ *  contexts - games played on many threads, every one in its own Engine context, against the same games played one after another
+ */
+
+#include "sim/bot.h"
+#include "sim/environment.h"
+#include "sim/tensorencoder.h"
+#include "app_state/game.h"
+#include "engine/engine.h"
+#include "engine/random.h"
+#include "engine/spatialhash.h"
+#include "engine/rectbatch.h"
+#include "objects/bulletpool.h"
+#include "objects/flowfield.h"
+#include "appconfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double microseconds(Clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+static void printUsage(const char* name)
+{
+    std::cout << "Usage: " << name << " NAME [options]" << std::endl
+              << "  snapshot [--level N] [--seed N] [--ticks N] [--interval N]" << std::endl
+              << "           save the game every tick, roll back every N ticks and replay the same controls" << std::endl
+              << "  broadphase [--steps N] [--seed N]" << std::endl
+              << "           find colliding pairs among 10, 100 and 1000 tanks and bullets with SpatialHash and by testing all pairs" << std::endl
+              << "  bullets [--shots N] [--live N]" << std::endl
+              << "           fire N bullets keeping the given number of them flying, with BulletPool and with new and delete" << std::endl
+              << "  rects [--count N] [--queries N]" << std::endl
+              << "           test N queries against N rectangles with the vector kernel of RectBatch and with intersectRect" << std::endl
+              << "  entities [--count N] [--ticks N]" << std::endl
+              << "           move N tanks and bullets, half of each, as objects and as arrays of a prototype EntityStore" << std::endl
+              << "  flowfield [--changes N] [--seed N]" << std::endl
+              << "           destroy and build N single walls on random maps, repairing the flow field and building it again" << std::endl
+              << "  env [--games N] [--steps N] [--threads N] [--level N] [--seed N] [--tensors]" << std::endl
+              << "           step N games (default 1, 64 and 1024) with random controls, writing observations into one buffer," << std::endl
+              << "           with --tensors also the arrays of TensorEncoder" << std::endl
+              << "  tensor [--level N] [--seed N] [--ticks N]" << std::endl
+              << "           encode a game played by two bots after every tick, updating the changes and writing the whole array" << std::endl
+              << "  contexts [--contexts N] [--ticks N] [--level N] [--seed N]" << std::endl
+              << "           play N games (default 64) at the same time, each on its own thread and in its own context, and compare" << std::endl
+              << "           them with the same games played one after another" << std::endl
+              << "Common options:" << std::endl
+              << "  --levels PATH  directory with levels (default " << AppConfig::levels_path << ")" << std::endl;
+}
+
+static int benchSnapshot(Engine* engine, int argc, char* args[])
+{
+    int level = 1;
+    Uint64 seed = 1;
+    unsigned long ticks = 20000;
+    unsigned interval = 100;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--level") && has_value) level = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--ticks") && has_value) ticks = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--interval") && has_value) interval = atoi(args[++i]);
+        else return 1;
+    }
+    if(interval == 0) return 1;
+
+    // play forward with two hunting bots, saving every tick and keeping every interval-th snapshot
+    Game game(engine, 2, seed, level);
+    Bot bots[2] = {Bot(BT_HUNTER, seed * 2 + 1), Bot(BT_HUNTER, seed * 2 + 2)};
+    std::vector<PlayerInputs> inputs;
+    std::vector<Uint64> checksums;
+    std::vector<Snapshot> checkpoints;
+    Snapshot snapshot;
+    Clock::duration save_time(0);
+    size_t max_size = 0, total_size = 0;
+
+    unsigned long tick;
+    for(tick = 0; tick < ticks && !game.finished(); tick++)
+    {
+        Clock::time_point start = Clock::now();
+        game.saveSnapshot(snapshot);
+        save_time += Clock::now() - start;
+        total_size += snapshot.size();
+        if(snapshot.size() > max_size) max_size = snapshot.size();
+        if(tick % interval == 0) checkpoints.push_back(snapshot);
+        checksums.push_back(game.checksum());
+
+        PlayerInputs input[2] = {0, 0};
+        for(auto player : game.getPlayers())
+        {
+            int index = (player->type == ST_PLAYER_1 ? 0 : 1);
+            input[index] = bots[index].think(&game, player, AppConfig::sim_tick_time);
+        }
+        inputs.push_back(input[0]);
+        inputs.push_back(input[1]);
+        game.setPlayerInput(0, input[0]);
+        game.setPlayerInput(1, input[1]);
+        game.update(AppConfig::sim_tick_time);
+    }
+    checksums.push_back(game.checksum());
+
+    // roll back to every checkpoint from the final state and play the same controls again
+    Clock::duration restore_time(0);
+    unsigned mismatches = 0;
+    for(unsigned c = 0; c < checkpoints.size(); c++)
+    {
+        Clock::time_point start = Clock::now();
+        bool restored = game.restoreSnapshot(checkpoints[c]);
+        restore_time += Clock::now() - start;
+
+        unsigned long first = c * interval;
+        unsigned long last = std::min<unsigned long>(first + interval, tick);
+        for(unsigned long t = first; t < last; t++)
+        {
+            game.setPlayerInput(0, inputs[2 * t]);
+            game.setPlayerInput(1, inputs[2 * t + 1]);
+            game.update(AppConfig::sim_tick_time);
+        }
+        if(!restored || game.checksum() != checksums[last]) mismatches++;
+    }
+
+    std::cout << "level " << level << ", seed " << seed << ", " << tick << " ticks, " << checkpoints.size() << " rollbacks" << std::endl
+              << "snapshot size: " << (tick ? total_size / tick : 0) << " B average, " << max_size << " B max" << std::endl
+              << "save: " << (tick ? microseconds(save_time) / tick : 0) << " us" << std::endl
+              << "restore: " << (checkpoints.empty() ? 0 : microseconds(restore_time) / checkpoints.size()) << " us" << std::endl
+              << "replayed after rollback: " << (checkpoints.size() - mismatches) << "/" << checkpoints.size() << " identical" << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+static bool intersects(const SDL_Rect& a, const SDL_Rect& b)
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static int benchBroadphase(int argc, char* args[])
+{
+    unsigned steps = 200;
+    Uint64 seed = 1;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--steps") && has_value) steps = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else return 1;
+    }
+
+    std::cout << "entities   pairs  all pairs [us]  grid [us]  speedup" << std::endl;
+    const unsigned entities[3] = {10, 100, 1000};
+    for(unsigned n : entities)
+    {
+        unsigned count = n / 2;
+        // tanks and bullets spread with the density of a crowded level: ten tanks on a 26x26 tile map
+        Random random(seed);
+        int side = AppConfig::map_rect.w * sqrt(count / 10.0) + AppConfig::tile_rect.w;
+        std::vector<SDL_Rect> tanks(count), bullets(count);
+        std::vector<SDL_Point> tank_moves(count), bullet_moves(count);
+        for(unsigned i = 0; i < count; i++)
+        {
+            tanks[i] = {(int)random.nextInt(side), (int)random.nextInt(side), 26, 26};
+            bullets[i] = {(int)random.nextInt(side), (int)random.nextInt(side), 4, 4};
+            tank_moves[i] = {(int)random.nextInt(3) - 1, (int)random.nextInt(3) - 1};
+            bullet_moves[i] = {(int)random.nextInt(9) - 4, (int)random.nextInt(9) - 4};
+        }
+
+        SpatialHash tank_grid(AppConfig::tile_rect.w), bullet_grid(AppConfig::tile_rect.w);
+        std::vector<int> candidates;
+        Clock::duration brute_time(0), grid_time(0);
+        unsigned long brute_pairs = 0, grid_pairs = 0;
+        for(unsigned step = 0; step < steps; step++)
+        {
+            for(unsigned i = 0; i < count; i++)
+            {
+                tanks[i].x = (tanks[i].x + tank_moves[i].x + side) % side;
+                tanks[i].y = (tanks[i].y + tank_moves[i].y + side) % side;
+                bullets[i].x = (bullets[i].x + bullet_moves[i].x + side) % side;
+                bullets[i].y = (bullets[i].y + bullet_moves[i].y + side) % side;
+            }
+
+            // tank-tank, bullet-tank and bullet-bullet pairs
+            Clock::time_point start = Clock::now();
+            for(unsigned i = 0; i < count; i++)
+            {
+                for(unsigned j = i + 1; j < count; j++)
+                {
+                    if(intersects(tanks[i], tanks[j])) brute_pairs++;
+                    if(intersects(bullets[i], bullets[j])) brute_pairs++;
+                }
+                for(unsigned j = 0; j < count; j++)
+                    if(intersects(bullets[i], tanks[j])) brute_pairs++;
+            }
+            brute_time += Clock::now() - start;
+
+            start = Clock::now();
+            tank_grid.clear();
+            bullet_grid.clear();
+            for(unsigned i = 0; i < count; i++)
+            {
+                tank_grid.insert(tanks[i], i);
+                bullet_grid.insert(bullets[i], i);
+            }
+            tank_grid.build();
+            bullet_grid.build();
+            for(unsigned i = 0; i < count; i++)
+            {
+                tank_grid.query(tanks[i], candidates);
+                for(int j : candidates)
+                    if(j > (int)i && intersects(tanks[i], tanks[j])) grid_pairs++;
+                bullet_grid.query(bullets[i], candidates);
+                for(int j : candidates)
+                    if(j > (int)i && intersects(bullets[i], bullets[j])) grid_pairs++;
+                tank_grid.query(bullets[i], candidates);
+                for(int j : candidates)
+                    if(intersects(bullets[i], tanks[j])) grid_pairs++;
+            }
+            grid_time += Clock::now() - start;
+        }
+
+        if(brute_pairs != grid_pairs)
+        {
+            std::cerr << "different pairs for " << n << " entities: " << brute_pairs << " and " << grid_pairs << std::endl;
+            return 2;
+        }
+        double brute = microseconds(brute_time) / steps;
+        double grid = microseconds(grid_time) / steps;
+        std::cout << std::setw(8) << n << std::setw(8) << brute_pairs / steps
+                  << std::setw(16) << brute << std::setw(11) << grid << std::setw(8) << std::setprecision(3) << brute / grid << "x" << std::setprecision(6) << std::endl;
+    }
+    return 0;
+}
+
+static int benchBullets(Engine* engine, int argc, char* args[])
+{
+    unsigned long shots = 1000000;
+    unsigned live = 64;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--shots") && has_value) shots = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--live") && has_value) live = atoi(args[++i]);
+        else return 1;
+    }
+    if(live == 0) return 1;
+
+    // every shot replaces a bullet that hit something, chosen at random like in a crowded level
+    Random random(1);
+    std::vector<unsigned> hits(shots);
+    for(auto& hit : hits) hit = random.nextInt(live);
+
+    std::vector<Bullet*> flying(live);
+    Clock::time_point start = Clock::now();
+    for(auto& bullet : flying) bullet = new Bullet(engine, 0, 0);
+    for(unsigned long s = 0; s < shots; s++)
+    {
+        delete flying[hits[s]];
+        flying[hits[s]] = new Bullet(engine, s % 400, s % 300);
+    }
+    for(auto bullet : flying) delete bullet;
+    double heap = microseconds(Clock::now() - start);
+
+    BulletPool pool(engine, live);
+    start = Clock::now();
+    for(auto& bullet : flying) bullet = pool.acquire(0, 0);
+    for(unsigned long s = 0; s < shots; s++)
+    {
+        pool.release(flying[hits[s]]);
+        flying[hits[s]] = pool.acquire(s % 400, s % 300);
+    }
+    for(auto bullet : flying) pool.release(bullet);
+    double pooled = microseconds(Clock::now() - start);
+
+    std::cout << shots << " shots, " << live << " bullets flying, peak " << pool.getPeakCount() << " in the pool" << std::endl
+              << "new/delete: " << heap * 1000 / shots << " ns per shot" << std::endl
+              << "BulletPool: " << pooled * 1000 / shots << " ns per shot" << std::endl;
+    return pool.getLiveCount() == 0 ? 0 : 2;
+}
+
+static int benchRects(int argc, char* args[])
+{
+    unsigned count = 1024;
+    unsigned long queries = 100000;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--count") && has_value) count = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--queries") && has_value) queries = strtoul(args[++i], nullptr, 10);
+        else return 1;
+    }
+    if(count == 0 || queries == 0) return 1;
+
+    // rectangles of bullets, fields and tanks scattered over the map
+    Random random(1);
+    std::vector<SDL_Rect> rects(count), tested(1024);
+    for(auto& r : rects) r = {(int)random.nextInt(416), (int)random.nextInt(416), 8 + (int)random.nextInt(25), 8 + (int)random.nextInt(25)};
+    for(auto& r : tested) r = {(int)random.nextInt(416), (int)random.nextInt(416), 8 + (int)random.nextInt(25), 8 + (int)random.nextInt(25)};
+    RectBatch batch;
+    for(const auto& r : rects) batch.add(r);
+
+    // both loops keep the number of hits, so the compiler cannot skip them
+    std::vector<Uint32> mask;
+    unsigned long scalar_hits = 0, batch_hits = 0;
+    Clock::time_point start = Clock::now();
+    for(unsigned long q = 0; q < queries; q++)
+    {
+        SDL_Rect& query = tested[q % tested.size()];
+        for(auto& r : rects)
+        {
+            SDL_Rect intersect = intersectRect(&query, &r);
+            if(intersect.w > 0 && intersect.h > 0) scalar_hits++;
+        }
+    }
+    double scalar_time = microseconds(Clock::now() - start);
+
+    start = Clock::now();
+    for(unsigned long q = 0; q < queries; q++)
+    {
+        batch.intersect(tested[q % tested.size()], mask);
+        for(Uint32 word : mask) batch_hits += __builtin_popcount(word);
+    }
+    double batch_time = microseconds(Clock::now() - start);
+
+    double tests = (double)queries * count;
+    std::cout << queries << " queries against " << count << " rectangles, " << scalar_hits << " hits" << std::endl
+              << "intersectRect: " << tests / (scalar_time * 1000) << " rect tests per ns" << std::endl
+              << "RectBatch (" << RectBatch::kernelName() << "): " << tests / (batch_time * 1000) << " rect tests per ns" << std::endl
+              << "same hits: " << (scalar_hits == batch_hits ? "yes" : "no") << std::endl;
+    return scalar_hits == batch_hits ? 0 : 2;
+}
+
+/**
+ * Flags of an entity in @a EntityStore.
+ */
+enum EntityFlag
+{
+    EF_MOVING = 1 << 0,
+    EF_ANIMATED = 1 << 1
+};
+
+/**
+ * @brief
+ * Prototype of storing tanks and bullets as a structure of arrays, measured against the objects of the game by the entities benchmark.
+ * An entity is an index into the arrays. Instead of a virtual @a update of every object, @a move, @a updateRects and @a animate
+ * walk once over the arrays they need, so a step reads memory linearly and the loops can be vectorised by the compiler.
+ * It is only a measurement: @a Game::step, the collision checks, the bots and the snapshots still work on @a Tank and @a Bullet objects.
+ */
+struct EntityStore
+{
+    /**
+     * Adding an entity standing still, with the first frame of its animation.
+     * @param inset - distance of the collision rectangle from every edge of the drawn rectangle, e.g. 2 for tanks
+     * @return index of the new entity
+     */
+    unsigned add(double x, double y, const SpriteData* sprite, int inset = 0)
+    {
+        pos_x.push_back(x);
+        pos_y.push_back(y);
+        velocity_x.push_back(0.0);
+        velocity_y.push_back(0.0);
+        flags.push_back(0);
+        dest_rect.push_back({(int)x, (int)y, sprite->rect.w, sprite->rect.h});
+        collision_x.push_back((int)x + inset);
+        collision_y.push_back((int)y + inset);
+        this->inset.push_back(inset);
+        this->sprite.push_back(sprite);
+        frame.push_back(0);
+        frame_time.push_back(0);
+        return size() - 1;
+    }
+    unsigned size() const { return pos_x.size(); }
+    /**
+     * Setting the direction and the distance travelled in one millisecond of an entity.
+     */
+    void setVelocity(unsigned index, Direction dir, double speed)
+    {
+        static const int direction_vector[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+        velocity_x[index] = direction_vector[dir][0] * speed;
+        velocity_y[index] = direction_vector[dir][1] * speed;
+    }
+    /**
+     * Moving all entities with the flag @a EF_MOVING by their velocity.
+     */
+    void move(Uint32 dt)
+    {
+        const unsigned count = size();
+        // a standing entity moves by zero instead of a branch, so the loop has no jumps
+        for(unsigned i = 0; i < count; i++)
+        {
+            double time = (flags[i] & EF_MOVING) ? dt : 0.0;
+            pos_x[i] += velocity_x[i] * time;
+            pos_y[i] += velocity_y[i] * time;
+        }
+    }
+    /**
+     * Calculating the drawn and the collision rectangles from the positions, like @a Object::update and @a Tank::update.
+     */
+    void updateRects()
+    {
+        const unsigned count = size();
+        for(unsigned i = 0; i < count; i++)
+        {
+            dest_rect[i].x = pos_x[i];
+            dest_rect[i].y = pos_y[i];
+            collision_x[i] = dest_rect[i].x + inset[i];
+            collision_y[i] = dest_rect[i].y + inset[i];
+        }
+    }
+    /**
+     * Counting the display time of frames of all entities with the flag @a EF_ANIMATED, like @a Object::update.
+     */
+    void animate(Uint32 dt)
+    {
+        const unsigned count = size();
+        for(unsigned i = 0; i < count; i++)
+        {
+            const SpriteData* s = sprite[i];
+            if(!(flags[i] & EF_ANIMATED) || s->frames_count <= 1) continue;
+            frame_time[i] += dt;
+            if(frame_time[i] <= s->frame_duration) continue;
+            frame_time[i] = 0;
+            frame[i]++;
+            if(frame[i] >= s->frames_count) frame[i] = s->loop ? 0 : s->frames_count - 1;
+        }
+    }
+
+    std::vector<double> pos_x, pos_y, velocity_x, velocity_y;
+    std::vector<Uint8> flags, inset;
+    std::vector<SDL_Rect> dest_rect;
+    std::vector<int> collision_x, collision_y;
+    std::vector<const SpriteData*> sprite;
+    std::vector<int> frame;
+    std::vector<Uint32> frame_time;
+};
+
+static int benchEntities(Engine* engine, int argc, char* args[])
+{
+    unsigned count = 10000;
+    unsigned long ticks = 1000;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--count") && has_value) count = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--ticks") && has_value) ticks = strtoul(args[++i], nullptr, 10);
+        else return 1;
+    }
+    if(count < 2 || ticks == 0) return 1;
+
+    // the layout of the game: tanks allocated separately, each with its bullet taken from the pool of the game
+    Random random(1);
+    unsigned tanks_count = count / 2;
+    BulletPool pool(engine, tanks_count);
+    std::vector<Tank*> tanks;
+    for(unsigned i = 0; i < tanks_count; i++)
+    {
+        Tank* tank = new Tank(engine, random.nextInt(400), random.nextInt(400), ST_TANK_A, GameConfig::defaults().get());
+        tank->setBulletPool(&pool);
+        tank->setFlag(TSF_LIFE);
+        tank->speed = tank->default_speed;
+        tank->direction = static_cast<Direction>(random.nextInt(4));
+        tank->fire();
+        tanks.push_back(tank);
+    }
+
+    // the same entities as arrays
+    EntityStore store;
+    const SpriteConfig* config = engine->getSpriteConfig();
+    for(auto tank : tanks)
+    {
+        unsigned index = store.add(tank->pos_x, tank->pos_y, config->getSpriteData(tank->type), 2);
+        store.setVelocity(index, tank->direction, tank->speed);
+        store.flags[index] = EF_MOVING | EF_ANIMATED;
+        for(auto bullet : tank->bullets)
+        {
+            index = store.add(bullet->pos_x, bullet->pos_y, config->getSpriteData(ST_BULLET));
+            store.setVelocity(index, bullet->direction, bullet->speed);
+            store.flags[index] = EF_MOVING;
+        }
+    }
+
+    Clock::time_point start = Clock::now();
+    for(unsigned long t = 0; t < ticks; t++)
+        for(auto tank : tanks) tank->update(AppConfig::sim_tick_time);
+    double objects_time = microseconds(Clock::now() - start);
+
+    start = Clock::now();
+    for(unsigned long t = 0; t < ticks; t++)
+    {
+        store.move(AppConfig::sim_tick_time);
+        store.updateRects();
+        store.animate(AppConfig::sim_tick_time);
+    }
+    double store_time = microseconds(Clock::now() - start);
+
+    // both layouts have to end in the same positions
+    unsigned mismatches = 0, index = 0;
+    for(auto tank : tanks)
+    {
+        if(tank->pos_x != store.pos_x[index] || tank->pos_y != store.pos_y[index] || tank->collision_rect.x != store.collision_x[index]) mismatches++;
+        index++;
+        for(auto bullet : tank->bullets)
+        {
+            if(bullet->pos_x != store.pos_x[index] || bullet->pos_y != store.pos_y[index] || bullet->collision_rect.y != store.collision_y[index]) mismatches++;
+            index++;
+        }
+    }
+    for(auto tank : tanks) delete tank;
+
+    unsigned long updates = ticks * store.size();
+    std::cout << store.size() << " entities, " << ticks << " ticks" << std::endl
+              << "Tank and Bullet objects: " << objects_time * 1000 / updates << " ns per entity, " << objects_time / ticks << " us per tick" << std::endl
+              << "EntityStore: " << store_time * 1000 / updates << " ns per entity, " << store_time / ticks << " us per tick" << std::endl
+              << "positions equal: " << (store.size() - mismatches) << "/" << store.size() << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+static int benchFlowField(Engine* engine, int argc, char* args[])
+{
+    unsigned changes = 200;
+    Uint64 seed = 1;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--changes") && has_value) changes = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else return 1;
+    }
+    if(changes == 0) return 1;
+
+    std::cout << std::setw(10) << "map" << std::setw(14) << "build [us]" << std::setw(18) << "repair [us/field]" << std::setw(10) << "speedup" << std::endl;
+    unsigned mismatches = 0;
+    const int sizes[] = {26, 64, 128, 256, 512, 1024};
+    for(int size : sizes)
+    {
+        // a third of the fields are brick walls and some are stone walls and water, the target is in the middle of the bottom row
+        Random random(seed);
+        Level level(engine);
+        level.resize(size, size);
+        for(int i = 0; i < size; i++)
+            for(int j = 0; j < size; j++)
+            {
+                Uint32 r = random.nextInt(100);
+                level.set(i, j, r < 30 ? ST_BRICK_WALL : r < 36 ? ST_STONE_WALL : r < 38 ? ST_WATER : ST_NONE);
+            }
+        SDL_Rect target = {(size / 2 - 1) * AppConfig::tile_rect.w, (size - 2) * AppConfig::tile_rect.h, 2 * AppConfig::tile_rect.w, 2 * AppConfig::tile_rect.h};
+        for(int i = size - 4; i < size; i++)
+            for(int j = size / 2 - 3; j < size / 2 + 3; j++)
+                level.set(i, j, ST_NONE);
+
+        FlowField field, built;
+        unsigned builds = std::max(1, 100000 / (size * size));
+        Clock::time_point start = Clock::now();
+        for(unsigned b = 0; b < builds; b++) built.build(level, target);
+        double build_time = microseconds(Clock::now() - start) / builds;
+
+        // every change destroys a wall, places a wall on an empty field or turns bricks into stone like the shovel
+        field.build(level, target);
+        Clock::duration repair_time(0);
+        std::vector<int> changed(1);
+        for(unsigned c = 0; c < changes; c++)
+        {
+            int row = random.nextInt(size), column = random.nextInt(size);
+            SpriteType type = level.getType(row, column);
+            level.set(row, column, type == ST_NONE ? ST_BRICK_WALL : type == ST_BRICK_WALL && c % 2 ? ST_STONE_WALL : ST_NONE);
+            changed[0] = row * size + column;
+            start = Clock::now();
+            field.repair(level, changed);
+            repair_time += Clock::now() - start;
+        }
+        built.build(level, target);
+        if(field.getDistances() != built.getDistances()) mismatches++;
+
+        double repair = microseconds(repair_time) / changes;
+        std::cout << std::setw(4) << size << "x" << std::setw(5) << std::left << size << std::right << std::setw(14) << std::fixed << std::setprecision(1) << build_time
+                  << std::setw(18) << std::setprecision(2) << repair << std::setw(9) << std::setprecision(0) << (repair > 0 ? build_time / repair : 0) << "x" << std::endl;
+    }
+    std::cout << "repaired fields equal to built ones: " << (sizeof(sizes) / sizeof(sizes[0]) - mismatches) << "/" << sizeof(sizes) / sizeof(sizes[0]) << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+static int benchEnvironment(int argc, char* args[])
+{
+    unsigned games = 0, threads = 0;
+    unsigned long steps = 1000;
+    bool tensors = false;
+    int level = 1;
+    Uint64 seed = 1;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--games") && has_value) games = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--steps") && has_value) steps = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--threads") && has_value) threads = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--tensors")) tensors = true;
+        else if(!strcmp(args[i], "--level") && has_value) level = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else return 1;
+    }
+    if(steps == 0) return 1;
+
+    std::vector<unsigned> counts;
+    if(games != 0) counts.push_back(games);
+    else counts = {1, 64, 1024};
+
+    // controls are drawn before the measurement and held for a few steps, like a policy choosing an action every few frames
+    const unsigned actions_count = 4096;
+    const PlayerInputs moves[5] = {0, PI_UP, PI_DOWN, PI_LEFT, PI_RIGHT};
+    Random random(seed);
+    std::vector<PlayerInputs> actions(actions_count);
+    for(auto& action : actions) action = moves[random.nextInt(5)] | (random.nextInt(2) ? PI_FIRE : 0);
+
+    for(unsigned count : counts)
+    {
+        Environment env(count, 1, threads);
+        std::vector<float> observations(count * Environment::observation_size);
+        std::vector<float> rewards(count);
+        std::vector<Uint8> done(count);
+        std::vector<PlayerInputs> step_actions(count);
+        std::vector<Uint8> maps(tensors ? count * Environment::getTensorSize() : 0);
+        if(tensors) env.setTensorBuffer(maps.data());
+
+        Clock::time_point start = Clock::now();
+        bool written = env.reset(seed, level, observations.data());
+        double reset_time = microseconds(Clock::now() - start);
+
+        unsigned long episodes = 0;
+        double reward_sum = 0;
+        start = Clock::now();
+        for(unsigned long t = 0; t < steps; t++)
+        {
+            for(unsigned i = 0; i < count; i++) step_actions[i] = actions[(i * 31 + t / 8) % actions_count];
+            written = env.step(step_actions.data(), observations.data(), rewards.data(), done.data()) && written;
+            for(unsigned i = 0; i < count; i++)
+            {
+                episodes += done[i];
+                reward_sum += rewards[i];
+            }
+        }
+        double step_time = microseconds(Clock::now() - start);
+
+        std::cout << std::setw(5) << count << " games: " << std::setw(10) << (unsigned long)(count * steps / step_time * 1e6) << " steps/s, "
+                  << step_time / steps << " us per step of all games, reset " << reset_time / 1000 << " ms, "
+                  << episodes << " episodes ended, reward " << reward_sum << std::endl;
+        if(!written)
+        {
+            std::cerr << "arrays of TensorEncoder not written, the map of level " << level << " is not loaded from " << AppConfig::levels_path << " or has another size" << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
+
+static int benchTensor(Engine* engine, int argc, char* args[])
+{
+    int level = 1;
+    Uint64 seed = 1;
+    unsigned long ticks = 20000;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--level") && has_value) level = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--ticks") && has_value) ticks = strtoul(args[++i], nullptr, 10);
+        else return 1;
+    }
+
+    Game game(engine, 2, seed, level);
+    if(game.getLevel().getRowsCount() == 0 || game.getLevel().getColumnsCount() == 0)
+    {
+        std::cerr << "cannot load level " << level << " from " << AppConfig::levels_path << std::endl;
+        return 2;
+    }
+    Bot bots[2] = {Bot(BT_HUNTER, seed * 2 + 1), Bot(BT_HUNTER, seed * 2 + 2)};
+    TensorEncoder incremental, full;
+    std::vector<Uint8> updated(TensorEncoder::size(game)), written(TensorEncoder::size(game));
+    Clock::duration incremental_time(0), full_time(0);
+    unsigned mismatches = 0;
+
+    unsigned long tick;
+    for(tick = 0; tick < ticks && !game.finished(); tick++)
+    {
+        for(auto player : game.getPlayers())
+        {
+            int index = (player->type == ST_PLAYER_1 ? 0 : 1);
+            game.setPlayerInput(index, bots[index].think(&game, player, AppConfig::sim_tick_time));
+        }
+        game.update(AppConfig::sim_tick_time);
+
+        Clock::time_point start = Clock::now();
+        incremental.encode(game, updated.data());
+        incremental_time += Clock::now() - start;
+
+        start = Clock::now();
+        full.reset();
+        full.encode(game, written.data());
+        full_time += Clock::now() - start;
+
+        if(updated != written) mismatches++;
+    }
+
+    std::cout << "level " << level << ", seed " << seed << ", " << tick << " ticks, " << updated.size() << " B per encoded game ("
+              << TC_COUNT << " channels of " << game.getLevel().getRowsCount() << "x" << game.getLevel().getColumnsCount() << ")" << std::endl
+              << "changes of the step: " << (unsigned long)(tick / (microseconds(incremental_time) / 1e6)) << " encodes/s, "
+              << microseconds(incremental_time) * 1000 / tick << " ns" << std::endl
+              << "whole array: " << (unsigned long)(tick / (microseconds(full_time) / 1e6)) << " encodes/s, "
+              << microseconds(full_time) * 1000 / tick << " ns" << std::endl
+              << "equal arrays: " << (tick - mismatches) << "/" << tick << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+/**
+ * Playing a level by two hunting bots in a new context without a renderer.
+ * @param config - rules of the game, shared with the games of other contexts
+ * @param ticks - number of played steps, fewer if the level ends before
+ * @param played - set to the number of played steps
+ * @param checksum - set to the value of @a Game::checksum after the last step
+ * @return @a false if the level could not be loaded, nothing is played then
+ */
+static bool playInContext(const GameConfigPtr& config, int level, Uint64 seed, unsigned long ticks, unsigned long& played, Uint64& checksum)
+{
+    Engine engine;
+    engine.initModules(false);
+    Game game(&engine, 2, seed, level, config);
+    played = 0;
+    checksum = 0;
+    if(game.getLevel().getRowsCount() == 0 || game.getLevel().getColumnsCount() == 0) return false;
+    Bot bots[2] = {Bot(BT_HUNTER, seed * 2 + 1), Bot(BT_HUNTER, seed * 2 + 2)};
+    for(played = 0; played < ticks && !game.finished(); played++)
+    {
+        for(auto player : game.getPlayers())
+        {
+            int index = (player->type == ST_PLAYER_1 ? 0 : 1);
+            game.setPlayerInput(index, bots[index].think(&game, player, AppConfig::sim_tick_time));
+        }
+        game.update(AppConfig::sim_tick_time);
+    }
+    checksum = game.checksum();
+    return true;
+}
+
+static int benchContexts(int argc, char* args[])
+{
+    unsigned contexts = 64;
+    unsigned long ticks = 5000;
+    int level = 1;
+    Uint64 seed = 1;
+    for(int i = 0; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--contexts") && has_value) contexts = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--ticks") && has_value) ticks = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--level") && has_value) level = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) seed = strtoull(args[++i], nullptr, 10);
+        else return 1;
+    }
+    if(contexts == 0) return 1;
+
+    // the same games one after another, every one in its own context, give the expected results; all games read one configuration
+    const GameConfigPtr& config = GameConfig::defaults();
+    std::vector<Uint64> expected(contexts), checksums(contexts);
+    std::vector<unsigned long> played(contexts);
+    std::vector<Uint8> loaded(contexts);
+    unsigned long total_ticks = 0;
+    Clock::time_point start = Clock::now();
+    for(unsigned c = 0; c < contexts; c++)
+    {
+        if(!playInContext(config, level, seed + c, ticks, played[c], expected[c]))
+        {
+            std::cerr << "cannot load level " << level << " from " << AppConfig::levels_path << std::endl;
+            return 2;
+        }
+        total_ticks += played[c];
+    }
+    double sequential = microseconds(Clock::now() - start) / 1e6;
+
+    // every thread creates its context, loads the level and plays it at the same time as the others
+    std::vector<std::thread> threads;
+    start = Clock::now();
+    for(unsigned c = 0; c < contexts; c++)
+        threads.push_back(std::thread([&, c]{ loaded[c] = playInContext(config, level, seed + c, ticks, played[c], checksums[c]); }));
+    for(auto& thread : threads) thread.join();
+    double concurrent = microseconds(Clock::now() - start) / 1e6;
+
+    unsigned mismatches = 0;
+    for(unsigned c = 0; c < contexts; c++)
+        if(!loaded[c] || checksums[c] != expected[c]) mismatches++;
+
+    std::cout << contexts << " contexts, level " << level << ", seeds " << seed << "-" << seed + contexts - 1 << ", " << total_ticks << " ticks in total" << std::endl
+              << "one after another: " << sequential << " s, " << (unsigned long)(sequential > 0 ? total_ticks / sequential : 0) << " ticks/s" << std::endl
+              << "at the same time: " << concurrent << " s, " << (unsigned long)(concurrent > 0 ? total_ticks / concurrent : 0) << " ticks/s" << std::endl
+              << "equal checksums: " << (contexts - mismatches) << "/" << contexts << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+int main( int argc, char* args[] )
+{
+    // common options are removed, the rest is passed to the selected benchmark
+    std::vector<char*> options;
+    for(int i = 2; i < argc; i++)
+    {
+        if(!strcmp(args[i], "--levels") && i + 1 < argc) AppConfig::levels_path = std::string(args[++i]) + "/";
+        else options.push_back(args[i]);
+    }
+    if(argc < 2)
+    {
+        printUsage(args[0]);
+        return 1;
+    }
+
+    // the benchmarks share one context without a renderer, the contexts benchmark creates its own
+    Engine engine;
+    engine.initModules(false);
+
+    int status = -1;
+    if(!strcmp(args[1], "snapshot")) status = benchSnapshot(&engine, options.size(), options.data());
+    else if(!strcmp(args[1], "broadphase")) status = benchBroadphase(options.size(), options.data());
+    else if(!strcmp(args[1], "bullets")) status = benchBullets(&engine, options.size(), options.data());
+    else if(!strcmp(args[1], "rects")) status = benchRects(options.size(), options.data());
+    else if(!strcmp(args[1], "entities")) status = benchEntities(&engine, options.size(), options.data());
+    else if(!strcmp(args[1], "flowfield")) status = benchFlowField(&engine, options.size(), options.data());
+    else if(!strcmp(args[1], "env")) status = benchEnvironment(options.size(), options.data());
+    else if(!strcmp(args[1], "tensor")) status = benchTensor(&engine, options.size(), options.data());
+    else if(!strcmp(args[1], "contexts")) status = benchContexts(options.size(), options.data());
+
+    if(status == -1 || status == 1) printUsage(args[0]);
+    return status == -1 ? 1 : status;
+}
@@ -0,0 +1,123 @@
+/**
+ * Headless simulation of the game.
+ * The program drives @a Game::update at full CPU speed without a window, renderer, vsync or audio
+ * and reports how many simulation ticks per second were computed.
+ *
+ * Usage: tanks-headless [--level N] [--players 1|2] [--matches N] [--seed N] [--ai NAME] [--ticks N] [--dt MS] [--speed N|max] [--levels PATH] [--record PATH]
+ *                       [--config FILE] [--set NAME=VALUE]
+ *        tanks-headless --replay FILE [--levels PATH] [--config FILE] [--set NAME=VALUE]
+ */
+
+#include "sim/match.h"
+#include "engine/engine.h"
+#include "appconfig.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static void printUsage(const char* name)
+{
+    std::cout << "Usage: " << name << " [options]" << std::endl
+              << "  --level N      first level of every match (default 1)" << std::endl
+              << "  --players N    number of players 1 or 2 (default 1)" << std::endl
+              << "  --matches N    number of matches played one after another (default 1)" << std::endl
+              << "  --seed N       random seed of the first match, next matches use following numbers (default 1)" << std::endl
+              << "  --ai NAME      bot steering the players: idle, random or hunter (default idle)" << std::endl
+              << "  --ticks N      tick limit of one match, 0 means one hour of game time (default 0)" << std::endl
+              << "  --dt MS        simulation step in milliseconds (default " << AppConfig::sim_tick_time << ")" << std::endl
+              << "  --speed N|max  play N times faster than real time, e.g. 10 or 100, above 1 the start and the end of a level are not slowed down (default max)" << std::endl
+              << "  --levels PATH  directory with levels (default " << AppConfig::levels_path << ")" << std::endl
+              << "  --record PATH  save the replay of every match to PATH, or PATH.SEED if many matches are played" << std::endl
+              << "  --config FILE  rules of the game, see GameConfig; a replay has to be played with the rules it was recorded with" << std::endl
+              << "  --set NAME=VALUE  change one rule of the game, e.g. enemy_max_count_on_map=8" << std::endl
+              << "  --replay FILE  play a recorded level instead of bot matches and verify that it gives the same result" << std::endl;
+}
+
+static int playReplay(const std::string& path, GameConfigPtr config)
+{
+    Replay replay;
+    if(!replay.load(path))
+    {
+        std::cerr << "Cannot load replay " << path << std::endl;
+        return 1;
+    }
+
+    MatchResult result = runReplay(replay, config);
+    bool verified = replay.getChecksum() == result.checksum;
+    double game_time = result.ticks * replay.getTickTime() / 1000.0;
+    const char* outcomes[3] = {"won", "lost", "timeout"};
+    std::cout << "replay: level " << replay.getLevel() << ", " << replay.getPlayersCount() << " player(s), seed " << replay.getSeed() << std::endl
+              << "result: " << outcomes[result.outcome] << ", score " << result.score << ", kills " << result.kills << std::endl
+              << "ticks: " << result.ticks << " (" << game_time << " s of game time)" << std::endl
+              << "wall time: " << result.wall_time << " s" << std::endl
+              << "speed: " << (result.wall_time > 0 ? game_time / result.wall_time : 0) << "x real time" << std::endl
+              << "checksum: " << (verified ? "match" : "MISMATCH") << std::endl;
+    return verified ? 0 : 2;
+}
+
+int main( int argc, char* args[] )
+{
+    MatchConfig config;
+    int matches = 1;
+    std::string record_path, replay_path;
+    GameConfig game_config;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(args[i], "--level") && has_value) config.level = atoi(args[++i]);
+        else if(!strcmp(args[i], "--players") && has_value) config.players_count = atoi(args[++i]);
+        else if(!strcmp(args[i], "--matches") && has_value) matches = atoi(args[++i]);
+        else if(!strcmp(args[i], "--seed") && has_value) config.seed = strtoull(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--ai") && has_value && Bot::parseType(args[i + 1], config.bot)) i++;
+        else if(!strcmp(args[i], "--ticks") && has_value) config.max_ticks = strtoul(args[++i], nullptr, 10);
+        else if(!strcmp(args[i], "--dt") && has_value) config.dt = atoi(args[++i]);
+        else if(!strcmp(args[i], "--speed") && has_value) config.time_scale = (strcmp(args[++i], "max") ? strtoul(args[i], nullptr, 10) : 0);
+        else if(!strcmp(args[i], "--levels") && has_value) AppConfig::levels_path = std::string(args[++i]) + "/";
+        else if(!strcmp(args[i], "--record") && has_value) record_path = args[++i];
+        else if(!strcmp(args[i], "--replay") && has_value) replay_path = args[++i];
+        else if(!strcmp(args[i], "--config") && has_value && game_config.load(args[i + 1])) i++;
+        else if(!strcmp(args[i], "--set") && has_value && game_config.set(args[i + 1])) i++;
+        else
+        {
+            printUsage(args[0]);
+            return 1;
+        }
+    }
+    config.game_config = std::make_shared<const GameConfig>(game_config);
+    if(!replay_path.empty()) return playReplay(replay_path, config.game_config);
+    if(config.dt == 0)
+    {
+        std::cerr << "dt has to be at least 1 ms" << std::endl;
+        return 1;
+    }
+    if(config.max_ticks == 0) config.max_ticks = 60 * 60 * 1000 / config.dt;
+
+    unsigned long total_ticks = 0;
+    double wall = 0;
+    int outcomes[3] = {0, 0, 0};
+    unsigned peak_bullets = 0, overflow_bullets = 0;
+    Uint64 first_seed = config.seed;
+    for(int m = 0; m < matches; m++)
+    {
+        config.seed = first_seed + m;
+        if(!record_path.empty()) config.record_path = (matches == 1 ? record_path : record_path + "." + Engine::intToString(config.seed));
+        MatchResult result = runMatch(config);
+        total_ticks += result.ticks;
+        wall += result.wall_time;
+        outcomes[result.outcome]++;
+        peak_bullets = std::max(peak_bullets, result.peak_bullets);
+        overflow_bullets += result.overflow_bullets;
+    }
+
+    double game_time = total_ticks * config.dt / 1000.0;
+    std::cout << "matches: " << matches << " (won " << outcomes[MO_WON] << ", lost " << outcomes[MO_LOST] << ", timeout " << outcomes[MO_TIMEOUT] << ")" << std::endl
+              << "ticks: " << total_ticks << " (" << game_time << " s of game time)" << std::endl
+              << "wall time: " << wall << " s" << std::endl
+              << "bullets: " << peak_bullets << " at most at the same time, " << overflow_bullets << " outside the pool" << std::endl
+              << "ticks/s: " << (wall > 0 ? total_ticks / wall : 0) << std::endl
+              << "speed: " << (wall > 0 ? game_time / wall : 0) << "x real time" << std::endl;
+    return 0;
+}